@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+// Structure of arrays float storage behind VertexStream and InstanceStream, one array per channel.
+// All channels share one zero filled allocation, each cache line aligned and padded to whole lines,
+// so batch loops can load whole SIMD lanes past the last element.
+template <uint32_t ChannelCount>
+class ChannelStorage
+{
+public:
+    static constexpr uint32_t kLaneWidth = 4;
+
+public:
+    ChannelStorage() = default;
+    ~ChannelStorage()
+    {
+        ::operator delete(mStorage, std::align_val_t(kAlignment));
+    }
+
+    ChannelStorage(const ChannelStorage&) = delete;
+    ChannelStorage& operator=(const ChannelStorage&) = delete;
+    ChannelStorage(ChannelStorage&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+    ChannelStorage& operator=(ChannelStorage&& other) noexcept
+    {
+        if (this != &other)
+        {
+            ::operator delete(mStorage, std::align_val_t(kAlignment));
+            mStorage = std::exchange(other.mStorage, nullptr);
+            mSize = std::exchange(other.mSize, 0);
+            mCapacity = std::exchange(other.mCapacity, 0);
+            for (uint32_t c = 0; c < ChannelCount; ++c)
+            {
+                mChannels[c] = std::exchange(other.mChannels[c], nullptr);
+            }
+        }
+        return *this;
+    }
+
+    void Clear() { mSize = 0; }
+    // Resize the storage, growing it while keeping existing elements
+    void Resize(uint32_t size)
+    {
+        Reserve(size);
+        mSize = size;
+    }
+    // Index of a new element at the end, its channels are left for the caller to fill
+    uint32_t Append()
+    {
+        if (mSize == mCapacity)
+        {
+            Reserve(mCapacity == 0 ? 256 : mCapacity * 2);
+        }
+        return mSize++;
+    }
+
+    uint32_t Size() const { return mSize; }
+    // Size rounded up to a whole number of SIMD lanes
+    uint32_t PaddedSize() const { return (mSize + kLaneWidth - 1) & ~(kLaneWidth - 1); }
+
+    float* Data(uint32_t channel) { return mChannels[channel]; }
+    const float* Data(uint32_t channel) const { return mChannels[channel]; }
+
+private:
+    // Cache line alignment, also covers any SIMD width we load with
+    static constexpr std::size_t kAlignment = 64;
+    // Channel capacity granularity, keeps every channel cache line aligned
+    static constexpr uint32_t kCapacityGranularity = kAlignment / sizeof(float);
+
+    void Reserve(uint32_t capacity)
+    {
+        capacity = (capacity + kCapacityGranularity - 1) & ~(kCapacityGranularity - 1);
+        if (capacity <= mCapacity)
+        {
+            return;
+        }
+
+        // One allocation for all channels, zero filled so padding lanes are always valid floats
+        const std::size_t bytes = static_cast<std::size_t>(capacity) * ChannelCount * sizeof(float);
+        float* storage = static_cast<float*>(::operator new(bytes, std::align_val_t(kAlignment)));
+        std::memset(storage, 0, bytes);
+
+        for (uint32_t c = 0; c < ChannelCount; ++c)
+        {
+            float* channel = storage + static_cast<std::size_t>(c) * capacity;
+            if (mSize > 0)
+            {
+                std::memcpy(channel, mChannels[c], mSize * sizeof(float));
+            }
+            mChannels[c] = channel;
+        }
+
+        ::operator delete(mStorage, std::align_val_t(kAlignment));
+        mStorage = storage;
+        mCapacity = capacity;
+    }
+
+    float* mStorage = nullptr;
+    float* mChannels[ChannelCount] = {};
+    uint32_t mSize = 0;
+    uint32_t mCapacity = 0;
+};
@@ -17,14 +17,57 @@ bool CmdBeginDraw::Execute(const std::vector<std::string>& params)
 	{
 		topology = Topology::Line;
 	}
+	else if(params[0] == "linestrip")
+	{
+		topology = Topology::LineStrip;
+	}
+	else if(params[0] == "lineloop")
+	{
+		topology = Topology::LineLoop;
+	}
 	else if(params[0] == "triangle")
 	{
 		topology = Topology::Triangle;
 	}
+	else if(params[0] == "trianglestrip")
+	{
+		topology = Topology::TriangleStrip;
+	}
+	else if(params[0] == "trianglefan")
+	{
+		topology = Topology::TriangleFan;
+	}
+	else if(params[0] == "polygon")
+	{
+		topology = Topology::Polygon;
+	}
 	else
 	{
 		return false;
 	}
 
-	return PrimitivesManager::Get()->BeginDraw(topology);
+	// Optional params to draw with an index list and pick the polygon fill rule
+	bool indexed = false;
+	FillRule fillRule = FillRule::NonZero;
+	for (size_t i = 1; i < params.size(); ++i)
+	{
+		if (params[i] == "indexed")
+		{
+			indexed = true;
+		}
+		else if (params[i] == "evenodd")
+		{
+			fillRule = FillRule::EvenOdd;
+		}
+		else if (params[i] == "nonzero")
+		{
+			fillRule = FillRule::NonZero;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return PrimitivesManager::Get()->BeginDraw(topology, indexed, fillRule);
 }
\ No newline at end of file
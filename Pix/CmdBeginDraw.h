@@ -11,10 +11,14 @@ public:
     }
     const char* GetDescription() override
     {
-        return "BeginDraw(topology)\n"
+        return "BeginDraw(topology, <indexed>, <evenodd|nonzero>)\n"
             "\n"
             "-starts storing vertices\n"
-            "-stores topology (point, line, triangle)";
+            "-stores topology (point, line, linestrip, lineloop,\n"
+            " triangle, trianglestrip, trianglefan, polygon)\n"
+            "-optional: indexed, primitives are built from Index() commands\n"
+            "-polygon fills one shape of any number of vertices, RestartStrip() starts another contour\n"
+            "-optional: evenodd or nonzero (default) fill rule for overlapping polygon contours";
     }
     bool Execute(const std::vector<std::string>& params) override;
 };
\ No newline at end of file
@@ -0,0 +1,13 @@
+#include "CmdBeginMesh.h"
+#include "MeshManager.h"
+
+bool CmdBeginMesh::Execute(const std::vector<std::string>& params)
+{
+    // Need 1 param for the mesh name
+    if (params.empty())
+    {
+        return false;
+    }
+
+    return MeshManager::Get()->BeginMesh(params[0]);
+}
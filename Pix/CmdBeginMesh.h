@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdBeginMesh : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "BeginMesh";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "BeginMesh(name)\n"
+            "\n"
+            "-records the following BeginDraw/EndDraw blocks into a mesh\n"
+            "-recorded once per run, variables are read at record time\n"
+            "-draw it with DrawMesh(name)";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,21 @@
+#include "CmdCubicTo.h"
+
+#include "PathManager.h"
+#include "VariableCache.h"
+
+bool CmdCubicTo::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 6)
+    {
+        return false;
+    }
+
+    float values[6];
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        values[i] = VariableCache::Get()->GetFloat(params[i]);
+    }
+
+    PathManager::Get()->CubicTo({ values[0], values[1] }, { values[2], values[3] }, { values[4], values[5] });
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdCubicTo : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "CubicTo";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "CubicTo(control0X, control0Y, control1X, control1Y, x, y)\n"
+            "\n"
+            "-adds a cubic curve to the path from the last point to (x, y)\n"
+            "-the curve is flattened to lines within a tenth of a pixel";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,38 @@
+#include "CmdDrawCircle.h"
+
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdDrawCircle::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() < 3 || params.size() > 5)
+    {
+        return false;
+    }
+
+    bool filled = false;
+    bool antiAliased = false;
+    for (size_t i = 3; i < params.size(); ++i)
+    {
+        if (params[i] == "filled")
+        {
+            filled = true;
+        }
+        else if (params[i] == "aa")
+        {
+            antiAliased = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    VariableCache* vc = VariableCache::Get();
+    const float x = vc->GetFloat(params[0]);
+    const float y = vc->GetFloat(params[1]);
+    const float radius = vc->GetFloat(params[2]);
+
+    Rasterizer::Get()->DrawEllipse(x, y, radius, radius, filled, antiAliased);
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawCircle : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "DrawCircle";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "DrawCircle(x, y, radius)\n"
+            "DrawCircle(x, y, radius, filled)\n"
+            "DrawCircle(x, y, radius, aa)\n"
+            "DrawCircle(x, y, radius, filled, aa)\n"
+            "\n"
+            "-draws a circle around (x, y) in pixels with the current color and blend mode\n"
+            "-filled draws the inside as well as the outline\n"
+            "-aa smooths the edge, otherwise it follows whole pixels";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
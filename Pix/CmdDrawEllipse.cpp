@@ -0,0 +1,39 @@
+#include "CmdDrawEllipse.h"
+
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdDrawEllipse::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() < 4 || params.size() > 6)
+    {
+        return false;
+    }
+
+    bool filled = false;
+    bool antiAliased = false;
+    for (size_t i = 4; i < params.size(); ++i)
+    {
+        if (params[i] == "filled")
+        {
+            filled = true;
+        }
+        else if (params[i] == "aa")
+        {
+            antiAliased = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    VariableCache* vc = VariableCache::Get();
+    const float x = vc->GetFloat(params[0]);
+    const float y = vc->GetFloat(params[1]);
+    const float radiusX = vc->GetFloat(params[2]);
+    const float radiusY = vc->GetFloat(params[3]);
+
+    Rasterizer::Get()->DrawEllipse(x, y, radiusX, radiusY, filled, antiAliased);
+    return true;
+}
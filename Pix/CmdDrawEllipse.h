@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawEllipse : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "DrawEllipse";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "DrawEllipse(x, y, radiusX, radiusY)\n"
+            "DrawEllipse(x, y, radiusX, radiusY, filled)\n"
+            "DrawEllipse(x, y, radiusX, radiusY, aa)\n"
+            "DrawEllipse(x, y, radiusX, radiusY, filled, aa)\n"
+            "\n"
+            "-draws an axis aligned ellipse around (x, y) in pixels with the current color and blend mode\n"
+            "-filled draws the inside as well as the outline\n"
+            "-aa smooths the edge, otherwise it follows whole pixels";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,46 @@
+#include "CmdDrawInstanced.h"
+#include "InstanceManager.h"
+#include "MeshManager.h"
+#include "VariableCache.h"
+
+bool CmdDrawInstanced::Execute(const std::vector<std::string>& params)
+{
+    // Need at least 2 params for the mesh name and the instance count
+    if (params.size() < 2)
+    {
+        return false;
+    }
+
+    VariableCache* vc = VariableCache::Get();
+    InstanceManager* im = InstanceManager::Get();
+    const float countValue = vc->GetFloat(params[1]);
+    const uint32_t count = countValue > 0.0f ? static_cast<uint32_t>(countValue) : 0;
+
+    const InstanceStream* instances = nullptr;
+    if (params.size() == 2)
+    {
+        instances = &im->GetScriptInstances();
+    }
+    else if (params[2] == "grid" && params.size() <= 4)
+    {
+        const float spacing = params.size() > 3 ? vc->GetFloat(params[3]) : 1.0f;
+        instances = &im->MakeGrid(count, spacing);
+    }
+    else if (params[2] == "random" && params.size() <= 5)
+    {
+        const float range = params.size() > 3 ? vc->GetFloat(params[3]) : 10.0f;
+        const uint32_t seed = params.size() > 4 ? static_cast<uint32_t>(vc->GetFloat(params[4])) : 0;
+        instances = &im->MakeRandom(count, range, seed);
+    }
+    else if (params[2] == "file" && params.size() == 4)
+    {
+        instances = im->LoadFile(params[3]);
+    }
+
+    if (instances == nullptr)
+    {
+        return false;
+    }
+
+    return MeshManager::Get()->DrawMeshInstanced(params[0], *instances, count);
+}
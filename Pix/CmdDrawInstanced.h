@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawInstanced : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "DrawInstanced";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "DrawInstanced(mesh, count)\n"
+            "DrawInstanced(mesh, count, grid, <spacing>)\n"
+            "DrawInstanced(mesh, count, random, <range>, <seed>)\n"
+            "DrawInstanced(mesh, count, file, fileName)\n"
+            "\n"
+            "-draws count copies of a mesh recorded with BeginMesh/EndMesh\n"
+            "-instances come from Instance(), a generator or a file\n"
+            "-grid: square grid centered on the origin, spacing defaults to 1\n"
+            "-random: offsets in [-range, range], range defaults to 10\n"
+            "-file: packed floats, offset x, y, z, scale, rotation, r, g, b, a, the name is relative to PixInstancePath";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
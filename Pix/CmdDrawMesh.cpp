@@ -0,0 +1,32 @@
+#include "CmdDrawMesh.h"
+#include "CmdSetWorld.h"
+#include "MeshManager.h"
+#include "TransformState.h"
+
+bool CmdDrawMesh::Execute(const std::vector<std::string>& params)
+{
+    // Need at least 1 param for the mesh name
+    if (params.empty())
+    {
+        return false;
+    }
+
+    if (params.size() == 1)
+    {
+        return MeshManager::Get()->DrawMesh(params[0]);
+    }
+
+    // Draw with its own world transform, then restore the current one
+    X::Math::Matrix4 world;
+    if (!CmdSetWorld::ParseWorld(params, 1, world))
+    {
+        return false;
+    }
+
+    TransformState* ts = TransformState::Get();
+    const X::Math::Matrix4 oldWorld = ts->GetWorld();
+    ts->SetWorld(world);
+    const bool result = MeshManager::Get()->DrawMesh(params[0]);
+    ts->SetWorld(oldWorld);
+    return result;
+}
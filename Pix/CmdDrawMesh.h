@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdDrawMesh : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "DrawMesh";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "DrawMesh(name)\n"
+            "DrawMesh(name, tx, ty, tz, <rx, ry, rz>, <sx, sy, sz>)\n"
+            "\n"
+            "-draws a mesh recorded with BeginMesh/EndMesh\n"
+            "-optional: world transform for this draw only, same as SetWorld\n"
+            "-vertices are only transformed again when the transform changes";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,7 @@
+#include "CmdEndMesh.h"
+#include "MeshManager.h"
+
+bool CmdEndMesh::Execute(const std::vector<std::string>& params)
+{
+    return MeshManager::Get()->EndMesh();
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdEndMesh : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "EndMesh";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "EndMesh()\n"
+            "\n"
+            "-stops recording the current mesh";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
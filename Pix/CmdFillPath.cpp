@@ -0,0 +1,27 @@
+#include "CmdFillPath.h"
+
+#include "PathManager.h"
+
+bool CmdFillPath::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() > 1)
+    {
+        return false;
+    }
+
+    FillRule rule = FillRule::NonZero;
+    if (params.size() == 1)
+    {
+        if (params[0] == "evenodd")
+        {
+            rule = FillRule::EvenOdd;
+        }
+        else if (params[0] != "nonzero")
+        {
+            return false;
+        }
+    }
+
+    PathManager::Get()->Fill(rule);
+    return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdFillPath : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "FillPath";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "FillPath()\n"
+            "FillPath(evenodd)\n"
+            "FillPath(nonzero)\n"
+            "\n"
+            "-fills the path with the current color and blend mode, with anti-aliased edges\n"
+            "-every contour is closed back to its start, overlaps follow the fill rule, nonzero by default\n"
+            "-the path is emptied for the next MoveTo";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
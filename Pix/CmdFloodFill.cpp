@@ -0,0 +1,20 @@
+#include "CmdFloodFill.h"
+
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdFloodFill::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 2 && params.size() != 3)
+    {
+        return false;
+    }
+
+    VariableCache* vc = VariableCache::Get();
+    const int x = static_cast<int>(vc->GetFloat(params[0]));
+    const int y = static_cast<int>(vc->GetFloat(params[1]));
+    const float tolerance = params.size() == 3 ? vc->GetFloat(params[2]) : 0.0f;
+
+    Rasterizer::Get()->FloodFill(x, y, tolerance);
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdFloodFill : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "FloodFill";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "FloodFill(x, y)\n"
+            "FloodFill(x, y, tolerance)\n"
+            "\n"
+            "-fills the connected area around (x, y) that has the same color as that pixel\n"
+            "-uses the current color and blend mode\n"
+            "-tolerance from 0 to 1 also fills pixels whose channels differ by up to that much, default 0";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,29 @@
+#include "CmdIndex.h"
+#include "PrimitivesManager.h"
+#include "VariableCache.h"
+
+bool CmdIndex::Execute(const std::vector<std::string>& params)
+{
+    // Need at least 1 index
+    if (params.empty())
+    {
+        return false;
+    }
+
+    VariableCache* vc = VariableCache::Get();
+    PrimitivesManager* pm = PrimitivesManager::Get();
+    for (const std::string& param : params)
+    {
+        const float index = vc->GetFloat(param);
+        if (index < 0.0f)
+        {
+            // Negative index is a primitive restart
+            pm->RestartPrimitive();
+        }
+        else
+        {
+            pm->AddIndex(static_cast<uint32_t>(index));
+        }
+    }
+    return true;
+}
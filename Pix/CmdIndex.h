@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdIndex : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "Index";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "Index(i, j, k, ...)\n"
+            "\n"
+            "-adds one or more indices into the vertex list\n"
+            "-an index of -1 restarts the strip/fan/loop\n"
+            "-only used between BeginDraw(topology, indexed) and EndDraw()";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
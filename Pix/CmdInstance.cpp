@@ -0,0 +1,32 @@
+#include "CmdInstance.h"
+#include "InstanceManager.h"
+#include "VariableCache.h"
+
+bool CmdInstance::Execute(const std::vector<std::string>& params)
+{
+    // Need 3, 4, 5 or 8 params
+    const size_t count = params.size();
+    if (count != 3 && count != 4 && count != 5 && count != 8)
+    {
+        return false;
+    }
+
+    VariableCache* vc = VariableCache::Get();
+    Instance instance;
+    instance.offset = { vc->GetFloat(params[0]), vc->GetFloat(params[1]), vc->GetFloat(params[2]) };
+    if (count >= 4)
+    {
+        instance.scale = vc->GetFloat(params[3]);
+    }
+    if (count >= 5)
+    {
+        instance.rotation = vc->GetFloat(params[4]);
+    }
+    if (count == 8)
+    {
+        instance.tint = { vc->GetFloat(params[5]), vc->GetFloat(params[6]), vc->GetFloat(params[7]), 1.0f };
+    }
+
+    InstanceManager::Get()->AddInstance(instance);
+    return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdInstance : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "Instance";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "Instance(x, y, z, <scale>, <rotation>, <r, g, b>)\n"
+            "\n"
+            "-adds an instance for DrawInstanced(mesh, count)\n"
+            "-rotation is around z in degrees\n"
+            "-r, g, b tints the mesh colors";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,19 @@
+#include "CmdLineTo.h"
+
+#include "PathManager.h"
+#include "VariableCache.h"
+
+bool CmdLineTo::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 2)
+    {
+        return false;
+    }
+
+    VariableCache* vc = VariableCache::Get();
+    const float x = vc->GetFloat(params[0]);
+    const float y = vc->GetFloat(params[1]);
+
+    PathManager::Get()->LineTo({ x, y });
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdLineTo : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "LineTo";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "LineTo(x, y)\n"
+            "\n"
+            "-adds a straight edge to the path from the last point to (x, y)";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdMoveTo : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "MoveTo";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "MoveTo(x, y)\n"
+            "\n"
+            "-starts a new contour of the path at (x, y) in pixels";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
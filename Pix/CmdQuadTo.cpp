@@ -0,0 +1,21 @@
+#include "CmdQuadTo.h"
+
+#include "PathManager.h"
+#include "VariableCache.h"
+
+bool CmdQuadTo::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 4)
+    {
+        return false;
+    }
+
+    float values[4];
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        values[i] = VariableCache::Get()->GetFloat(params[i]);
+    }
+
+    PathManager::Get()->QuadTo({ values[0], values[1] }, { values[2], values[3] });
+    return true;
+}
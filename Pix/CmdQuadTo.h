@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdQuadTo : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "QuadTo";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "QuadTo(controlX, controlY, x, y)\n"
+            "\n"
+            "-adds a quadratic curve to the path from the last point to (x, y)\n"
+            "-the curve is flattened to lines within a tenth of a pixel";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
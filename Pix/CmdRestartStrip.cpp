@@ -0,0 +1,8 @@
+#include "CmdRestartStrip.h"
+#include "PrimitivesManager.h"
+
+bool CmdRestartStrip::Execute(const std::vector<std::string>& params)
+{
+    PrimitivesManager::Get()->RestartPrimitive();
+    return true;
+}
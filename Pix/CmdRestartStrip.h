@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdRestartStrip : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "RestartStrip";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "RestartStrip()\n"
+            "\n"
+            "-ends the current strip, fan, loop or polygon contour\n"
+            "-the next vertex starts a new one in the same draw\n"
+            "-in a polygon it starts a new contour of the same shape";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
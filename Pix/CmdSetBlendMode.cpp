@@ -0,0 +1,40 @@
+#include "CmdSetBlendMode.h"
+
+#include "Rasterizer.h"
+
+bool CmdSetBlendMode::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    BlendMode mode = BlendMode::Opaque;
+    if (params[0] == "opaque")
+    {
+        mode = BlendMode::Opaque;
+    }
+    else if (params[0] == "alpha")
+    {
+        mode = BlendMode::Alpha;
+    }
+    else if (params[0] == "additive")
+    {
+        mode = BlendMode::Additive;
+    }
+    else if (params[0] == "multiply")
+    {
+        mode = BlendMode::Multiply;
+    }
+    else if (params[0] == "premultiplied")
+    {
+        mode = BlendMode::Premultiplied;
+    }
+    else
+    {
+        return false;
+    }
+
+    Rasterizer::Get()->SetBlendMode(mode);
+    return true;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetBlendMode : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetBlendMode";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetBlendMode(opaque)\n"
+            "SetBlendMode(alpha)\n"
+            "SetBlendMode(additive)\n"
+            "SetBlendMode(multiply)\n"
+            "SetBlendMode(premultiplied)\n"
+            "\n"
+            "-sets how drawn pixels combine with the frame buffer, default is opaque\n"
+            "-alpha and additive weight the color by its alpha\n"
+            "-multiply darkens by the color, faded towards no change by alpha\n"
+            "-premultiplied expects colors already multiplied by alpha";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -13,8 +13,9 @@ public:
     {
         return
             "SetColor(r, g, b)\n"
+            "SetColor(r, g, b, a)\n"
             "\n"
-            "- Sets the color of the next pixel using red, green and blue\n"
+            "- Sets the color of the next pixel using red, green, blue and optional alpha\n"
             "- Values are from 0.0 - 1.0";
     }
     bool Execute(const std::vector<std::string>& params) override;
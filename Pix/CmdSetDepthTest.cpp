@@ -0,0 +1,25 @@
+#include "CmdSetDepthTest.h"
+
+#include "Rasterizer.h"
+
+bool CmdSetDepthTest::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    if (params[0] == "on")
+    {
+        Rasterizer::Get()->SetDepthTest(true);
+    }
+    else if (params[0] == "off")
+    {
+        Rasterizer::Get()->SetDepthTest(false);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetDepthTest : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetDepthTest";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetDepthTest(on)\n"
+            "SetDepthTest(off)\n"
+            "\n"
+            "-with depth test on, triangle pixels behind what is already drawn are skipped\n"
+            "-depth is reset every frame, default is off";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
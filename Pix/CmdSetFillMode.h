@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetFillMode : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetFillMode";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetFillMode(solid)\n"
+            "SetFillMode(wireframe)\n"
+            "\n"
+            "-sets whether triangles are filled or drawn as outlines, default is solid";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
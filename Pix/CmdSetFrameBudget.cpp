@@ -0,0 +1,26 @@
+#include "CmdSetFrameBudget.h"
+
+#include "FrameBuffer.h"
+#include "VariableCache.h"
+
+bool CmdSetFrameBudget::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    if (params[0] == "off")
+    {
+        FrameBuffer::Get()->SetFrameBudget(0.0f);
+        return true;
+    }
+
+    const float milliseconds = VariableCache::Get()->GetFloat(params[0]);
+    if (milliseconds <= 0.0f)
+    {
+        return false;
+    }
+    FrameBuffer::Get()->SetFrameBudget(milliseconds);
+    return true;
+}
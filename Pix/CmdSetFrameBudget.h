@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetFrameBudget : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetFrameBudget";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetFrameBudget(milliseconds)\n"
+            "SetFrameBudget(off)\n"
+            "\n"
+            "-frames that change take at most about this long, for scenes too heavy to draw at once\n"
+            "-the script runs again for each share of tiles that fits, tiles that do not fit still show\n"
+            " the last frame and are drawn in the next frames\n"
+            "-the budget is reset every frame, default is off";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,25 @@
+#include "CmdSetLineSmooth.h"
+
+#include "Rasterizer.h"
+
+bool CmdSetLineSmooth::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    if (params[0] == "on")
+    {
+        Rasterizer::Get()->SetLineSmooth(true);
+    }
+    else if (params[0] == "off")
+    {
+        Rasterizer::Get()->SetLineSmooth(false);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetLineSmooth : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetLineSmooth";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetLineSmooth(on)\n"
+            "SetLineSmooth(off)\n"
+            "\n"
+            "-with smoothing on, lines and wireframe edges blend their edge pixels by coverage\n"
+            "-works with any blend mode, opaque lines blend only at the edges\n"
+            "-default is off, reset every frame";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
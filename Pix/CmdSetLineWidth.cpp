@@ -0,0 +1,15 @@
+#include "CmdSetLineWidth.h"
+
+#include "Rasterizer.h"
+#include "VariableCache.h"
+
+bool CmdSetLineWidth::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    Rasterizer::Get()->SetLineWidth(VariableCache::Get()->GetFloat(params[0]));
+    return true;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetLineWidth : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetLineWidth";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetLineWidth(width)\n"
+            "\n"
+            "-width in pixels of lines and wireframe edges, from 1 to 32\n"
+            "-reset to 1 every frame";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,49 @@
+#include "CmdSetMemoryLayout.h"
+
+#include "FrameBuffer.h"
+#include "TextureCache.h"
+
+bool CmdSetMemoryLayout::Execute(const std::vector<std::string>& params)
+{
+    // Need 2 params for the target and the layout
+    if (params.size() != 2)
+    {
+        return false;
+    }
+
+    MemoryLayout layout = MemoryLayout::Linear;
+    if (params[1] == "linear")
+    {
+        layout = MemoryLayout::Linear;
+    }
+    else if (params[1] == "tiled4")
+    {
+        layout = MemoryLayout::Tiled4x4;
+    }
+    else if (params[1] == "tiled8")
+    {
+        layout = MemoryLayout::Tiled8x8;
+    }
+    else if (params[1] == "morton")
+    {
+        layout = MemoryLayout::Morton;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (params[0] == "framebuffer")
+    {
+        FrameBuffer::Get()->SetLayout(layout);
+    }
+    else if (params[0] == "texture")
+    {
+        TextureCache::Get()->SetLayout(layout);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetMemoryLayout : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetMemoryLayout";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetMemoryLayout(framebuffer, layout)\n"
+            "SetMemoryLayout(texture, layout)\n"
+            "\n"
+            "-sets how pixels/texels are ordered in memory\n"
+            "-layout: linear, tiled4, tiled8 or morton\n"
+            "-output is the same, only cache behaviour changes\n"
+            "-reset to linear when the script is run";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,29 @@
+#include "CmdSetMultisample.h"
+
+#include "FrameBuffer.h"
+
+bool CmdSetMultisample::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    if (params[0] == "4")
+    {
+        FrameBuffer::Get()->SetSampleCount(4);
+    }
+    else if (params[0] == "8")
+    {
+        FrameBuffer::Get()->SetSampleCount(8);
+    }
+    else if (params[0] == "off")
+    {
+        FrameBuffer::Get()->SetSampleCount(1);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetMultisample : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetMultisample";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetMultisample(4)\n"
+            "SetMultisample(8)\n"
+            "SetMultisample(off)\n"
+            "\n"
+            "-triangles drawn after it take coverage at 4 or 8 samples per pixel for smooth edges\n"
+            "-color is still shaded once per pixel, partly covered pixels are averaged at the end of the frame\n"
+            "-multisampling is reset every frame, default is off";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
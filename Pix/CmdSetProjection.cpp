@@ -0,0 +1,25 @@
+#include "CmdSetProjection.h"
+
+#include "TransformState.h"
+#include "VariableCache.h"
+
+extern float gResolutionX;
+extern float gResolutionY;
+
+bool CmdSetProjection::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 1 param for fov
+	if (params.empty())
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const float fov = vc->GetFloat(params[0]);
+	const float nearPlane = params.size() > 1 ? vc->GetFloat(params[1]) : 0.1f;
+	const float farPlane = params.size() > 2 ? vc->GetFloat(params[2]) : 100.0f;
+	if (fov <= 0.0f || fov >= 180.0f || nearPlane <= 0.0f || farPlane <= nearPlane)
+		return false;
+
+	const float aspectRatio = gResolutionY > 0.0f ? gResolutionX / gResolutionY : 1.0f;
+	TransformState::Get()->SetProjection(TransformState::MakePerspective(fov, aspectRatio, nearPlane, farPlane));
+	return true;
+}
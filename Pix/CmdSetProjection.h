@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetProjection : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetProjection";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetProjection(fov, <near>, <far>)\n"
+			"\n"
+			"- Enables perspective projection with a vertical fov in degrees.\n"
+			"- Vertices are then in world units and mapped to the viewport.\n"
+			"- Optional: near and far planes, default = 0.1 and 100.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
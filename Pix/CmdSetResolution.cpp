@@ -1,6 +1,7 @@
 #include "CmdSetResolution.h"
 
-#include <XEngine.h>
+#include "FrameBuffer.h"
+#include "RenderWorker.h"
 
 float gResolutionX = 0.0f;
 float gResolutionY = 0.0f;
@@ -24,10 +25,9 @@ bool CmdSetResolution::Execute(const std::vector<std::string>& params)
 	gResolutionX = (float)width;
 	gResolutionY = (float)height;
 
-	X::InitRenderTexture(width, height, pixelSize);
-
-	if (showGrid && pixelSize > 1)
-		X::DrawScreenGrid(pixelSize, X::Colors::DarkGray);
+	// The editor thread sizes the render texture and draws the grid when it presents the frame
+	FrameBuffer::Get()->Initialize(width, height);
+	RenderWorker::Get()->SetDisplay(pixelSize, showGrid);
 
 	return true;
 }
@@ -0,0 +1,28 @@
+#include "CmdSetShadeMode.h"
+
+#include "Rasterizer.h"
+
+bool CmdSetShadeMode::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    ShadeMode shadeMode = ShadeMode::Gouraud;
+    if (params[0] == "gouraud")
+    {
+        shadeMode = ShadeMode::Gouraud;
+    }
+    else if (params[0] == "flat")
+    {
+        shadeMode = ShadeMode::Flat;
+    }
+    else
+    {
+        return false;
+    }
+
+    Rasterizer::Get()->SetShadeMode(shadeMode);
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetShadeMode : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetShadeMode";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetShadeMode(gouraud)\n"
+            "SetShadeMode(flat)\n"
+            "\n"
+            "-sets how colors fill triangles, default is gouraud\n"
+            "-gouraud interpolates the vertex colors\n"
+            "-flat uses the color of the first vertex";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
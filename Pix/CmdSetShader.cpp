@@ -0,0 +1,27 @@
+#include "CmdSetShader.h"
+
+#include "Rasterizer.h"
+#include "ShaderLibrary.h"
+
+bool CmdSetShader::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    if (params[0] == "none")
+    {
+        Rasterizer::Get()->SetShader(nullptr);
+        return true;
+    }
+
+    const Shader* shader = ShaderLibrary::Get()->ShaderLookup(params[0]);
+    if (shader == nullptr)
+    {
+        return false;
+    }
+
+    Rasterizer::Get()->SetShader(shader);
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetShader : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetShader";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetShader(gouraud)\n"
+            "SetShader(textured)\n"
+            "SetShader(none)\n"
+            "\n"
+            "-runs triangles through a programmable shader instead of the fixed pipeline\n"
+            "-gouraud interpolates the vertex colors\n"
+            "-textured modulates the bound texture and discards pixels with alpha below 0.5\n"
+            "-none goes back to the fixed pipeline, which is also the default";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,28 @@
+#include "CmdSetTexture.h"
+
+#include "Rasterizer.h"
+#include "TextureCache.h"
+
+bool CmdSetTexture::Execute(const std::vector<std::string>& params)
+{
+    // Need 1 param for the file name
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    if (params[0] == "none")
+    {
+        Rasterizer::Get()->SetTexture(nullptr);
+        return true;
+    }
+
+    const Texture* texture = TextureCache::Get()->GetTexture(params[0]);
+    if (texture == nullptr)
+    {
+        return false;
+    }
+
+    Rasterizer::Get()->SetTexture(texture);
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetTexture : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetTexture";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetTexture(fileName)\n"
+            "SetTexture(none)\n"
+            "\n"
+            "-textures filled triangles with a BMP from the Images folder\n"
+            "-the texture color is multiplied by the vertex color\n"
+            "-texture coordinates come from TexVertex(x, y, z, u, v) or Vertex(x, y, z, r, g, b, u, v)";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,32 @@
+#include "CmdSetTextureFilter.h"
+
+#include "Rasterizer.h"
+
+bool CmdSetTextureFilter::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 1)
+    {
+        return false;
+    }
+
+    TextureFilter filter = TextureFilter::Bilinear;
+    if (params[0] == "nearest")
+    {
+        filter = TextureFilter::Nearest;
+    }
+    else if (params[0] == "bilinear")
+    {
+        filter = TextureFilter::Bilinear;
+    }
+    else if (params[0] == "trilinear")
+    {
+        filter = TextureFilter::Trilinear;
+    }
+    else
+    {
+        return false;
+    }
+
+    Rasterizer::Get()->SetTextureFilter(filter);
+    return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetTextureFilter : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "SetTextureFilter";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "SetTextureFilter(nearest)\n"
+            "SetTextureFilter(bilinear)\n"
+            "SetTextureFilter(trilinear)\n"
+            "\n"
+            "-sets how textures are sampled, default is bilinear\n"
+            "-nearest and bilinear use the closest mip level\n"
+            "-trilinear blends the two closest mip levels";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -0,0 +1,23 @@
+#include "CmdSetView.h"
+
+#include "TransformState.h"
+#include "VariableCache.h"
+
+bool CmdSetView::Execute(const std::vector<std::string>& params)
+{
+	// Need at least 3 params for the eye position
+	if (params.size() < 3)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	const X::Math::Vector3 eye(vc->GetFloat(params[0]), vc->GetFloat(params[1]), vc->GetFloat(params[2]));
+	X::Math::Vector3 target = eye + X::Math::Vector3::ZAxis();
+	if (params.size() >= 6)
+		target = { vc->GetFloat(params[3]), vc->GetFloat(params[4]), vc->GetFloat(params[5]) };
+
+	if (X::Math::MagnitudeSqr(target - eye) <= 0.0f)
+		return false;
+
+	TransformState::Get()->SetView(TransformState::MakeLookAt(eye, target));
+	return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdSetView : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetView";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetView(eyeX, eyeY, eyeZ, <targetX, targetY, targetZ>)\n"
+			"\n"
+			"- Sets the camera position for the following draws.\n"
+			"- Optional: point to look at, default looks down +z.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+};
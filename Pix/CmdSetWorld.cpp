@@ -0,0 +1,38 @@
+#include "CmdSetWorld.h"
+
+#include "TransformState.h"
+#include "VariableCache.h"
+
+bool CmdSetWorld::Execute(const std::vector<std::string>& params)
+{
+	X::Math::Matrix4 world;
+	if (!ParseWorld(params, 0, world))
+		return false;
+
+	TransformState::Get()->SetWorld(world);
+	return true;
+}
+
+bool CmdSetWorld::ParseWorld(const std::vector<std::string>& params, size_t first, X::Math::Matrix4& world)
+{
+	// Need at least 3 params for tx, ty, tz
+	const size_t count = params.size() > first ? params.size() - first : 0;
+	if (count != 3 && count != 6 && count != 7 && count != 9)
+		return false;
+
+	VariableCache* vc = VariableCache::Get();
+	auto get = [&](size_t i) { return vc->GetFloat(params[first + i]); };
+
+	const X::Math::Vector3 translation(get(0), get(1), get(2));
+	X::Math::Vector3 rotation;
+	X::Math::Vector3 scale(1.0f);
+	if (count >= 6)
+		rotation = { get(3), get(4), get(5) };
+	if (count == 7)
+		scale = X::Math::Vector3(get(6));
+	else if (count == 9)
+		scale = { get(6), get(7), get(8) };
+
+	world = TransformState::MakeWorld(translation, rotation, scale);
+	return true;
+}
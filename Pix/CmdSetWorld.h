@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Command.h"
+
+#include <XMath.h>
+
+class CmdSetWorld : public Command
+{
+public:
+	const char* GetName() override
+	{
+		return "SetWorld";
+	}
+
+	const char* GetDescription() override
+	{
+		return
+			"SetWorld(tx, ty, tz, <rx, ry, rz>, <sx, sy, sz>)\n"
+			"\n"
+			"- Sets the world transform applied to the following draws.\n"
+			"- Optional: rotation in degrees around x, y and z.\n"
+			"- Optional: scale, either one uniform value or sx, sy, sz.";
+	}
+
+	bool Execute(const std::vector<std::string>& params) override;
+
+	// Builds a world matrix from params starting at first, shared with other commands
+	static bool ParseWorld(const std::vector<std::string>& params, size_t first, X::Math::Matrix4& world);
+};
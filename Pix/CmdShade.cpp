@@ -0,0 +1,197 @@
+#include "CmdShade.h"
+
+#include "FrameBuffer.h"
+#include "VariableCache.h"
+
+#include <XEngine.h>
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+    constexpr int kChannelCount = 3;
+    constexpr int kGroupCount = ShadeProgram::kGroupCount;
+    constexpr int kBatchSize = ShadeProgram::kBatchSize;
+
+    struct Channel
+    {
+        const ShadeProgram* program;
+        std::vector<float> uniforms;
+    };
+
+    // Evaluate every channel for row y and pack the result into pixels
+    void ShadeRow(const Channel (&channels)[kChannelCount], __m128* stack, int y, int left, int right, float areaLeft, float areaTop, float invWidth, float invHeight, uint32_t* pixels)
+    {
+        alignas(16) __m128 inputs[ShadeProgram::InputCount][kGroupCount];
+        alignas(16) __m128 results[kChannelCount][kGroupCount];
+        const __m128 laneOffsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        // x and y are whole pixel coordinates, u and v sample pixel centers
+        const __m128 pixelY = _mm_set1_ps(static_cast<float>(y));
+        const __m128 v = _mm_set1_ps((static_cast<float>(y) + 0.5f - areaTop) * invHeight);
+        for (int i = 0; i < kGroupCount; ++i)
+        {
+            inputs[ShadeProgram::Y][i] = pixelY;
+            inputs[ShadeProgram::V][i] = v;
+        }
+
+        for (int batchX = left; batchX < right; batchX += kBatchSize)
+        {
+            for (int i = 0; i < kGroupCount; ++i)
+            {
+                const __m128 x = _mm_add_ps(_mm_set1_ps(static_cast<float>(batchX + i * 4)), laneOffsets);
+                inputs[ShadeProgram::X][i] = x;
+                inputs[ShadeProgram::U][i] = _mm_mul_ps(_mm_sub_ps(x, _mm_set1_ps(areaLeft - 0.5f)), _mm_set1_ps(invWidth));
+            }
+            for (int c = 0; c < kChannelCount; ++c)
+            {
+                channels[c].program->Evaluate(inputs, channels[c].uniforms.data(), stack, results[c]);
+            }
+
+            const int count = std::min(kBatchSize, right - batchX);
+            alignas(16) uint32_t packed[kBatchSize];
+            const __m128 one = _mm_set1_ps(1.0f);
+            for (int i = 0; i < kGroupCount; ++i)
+            {
+                _mm_store_si128(reinterpret_cast<__m128i*>(packed + i * 4), FrameBuffer::PackColors(results[0][i], results[1][i], results[2][i], one));
+            }
+            std::copy_n(packed, count, pixels + (batchX - left));
+        }
+    }
+}
+
+const ShadeProgram* CmdShade::GetProgram(const std::string& expression)
+{
+    auto iter = mPrograms.find(expression);
+    if (iter != mPrograms.end())
+    {
+        return &iter->second;
+    }
+
+    ShadeProgram program;
+    std::string error;
+    if (!program.Compile(expression, error))
+    {
+        XLOG("[Shade] %s: %s", expression.c_str(), error.c_str());
+        return nullptr;
+    }
+    return &mPrograms.emplace(expression, std::move(program)).first->second;
+}
+
+bool CmdShade::Execute(const std::vector<std::string>& params)
+{
+    if (params.size() != 3 && params.size() != 7)
+    {
+        return false;
+    }
+
+    FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const int width = static_cast<int>(frameBuffer->GetWidth());
+    const int height = static_cast<int>(frameBuffer->GetHeight());
+
+    // Half open area, u and v span the requested rectangle even where it is clipped
+    float areaLeft = 0.0f;
+    float areaTop = 0.0f;
+    float areaRight = static_cast<float>(width);
+    float areaBottom = static_cast<float>(height);
+    if (params.size() == 7)
+    {
+        VariableCache* vc = VariableCache::Get();
+        areaLeft = vc->GetFloat(params[3]);
+        areaTop = vc->GetFloat(params[4]);
+        areaRight = vc->GetFloat(params[5]);
+        areaBottom = vc->GetFloat(params[6]);
+    }
+    const int left = std::max(static_cast<int>(areaLeft), 0);
+    const int top = std::max(static_cast<int>(areaTop), 0);
+    const int right = std::min(static_cast<int>(areaRight), width);
+    const int bottom = std::min(static_cast<int>(areaBottom), height);
+
+    Channel channels[kChannelCount];
+    for (int c = 0; c < kChannelCount; ++c)
+    {
+        channels[c].program = GetProgram(params[c]);
+        if (channels[c].program == nullptr)
+        {
+            return false;
+        }
+        for (const std::string& name : channels[c].program->GetUniformNames())
+        {
+            channels[c].uniforms.push_back(VariableCache::Get()->GetFloat(name));
+        }
+    }
+    if (left >= right || top >= bottom)
+    {
+        return true;
+    }
+
+    // Unchanged expressions, uniforms and area leave the pixels as the last frame kept them
+    const float area[] = { areaLeft, areaTop, areaRight, areaBottom };
+    uint64_t hash = FrameBuffer::HashInput(area, sizeof(area));
+    for (int c = 0; c < kChannelCount; ++c)
+    {
+        hash = FrameBuffer::HashInput(params[c].data(), params[c].size(), hash);
+        hash = FrameBuffer::HashInput(channels[c].uniforms.data(), channels[c].uniforms.size() * sizeof(float), hash);
+    }
+    if (!frameBuffer->AddTileInput(left, top, right - 1, bottom - 1, hash))
+    {
+        return true;
+    }
+
+    int stackDepth = 0;
+    for (const Channel& channel : channels)
+    {
+        stackDepth = std::max(stackDepth, channel.program->GetStackDepth());
+    }
+
+    const int rowWidth = right - left;
+    const int rowCount = bottom - top;
+
+    // Only the part of each row from the first to the last tile that is not kept gets shaded, the rest would be dropped
+    std::vector<int> rowLeft(rowCount, right);
+    std::vector<int> rowRight(rowCount, left);
+    for (int bandTop = top; bandTop < bottom; bandTop = (bandTop & ~(FrameBuffer::kTileSize - 1)) + FrameBuffer::kTileSize)
+    {
+        const int bandBottom = std::min((bandTop | (FrameBuffer::kTileSize - 1)) + 1, bottom);
+        int spanLeft = right;
+        int spanRight = left;
+        for (int tileLeft = left; tileLeft < right; tileLeft = (tileLeft & ~(FrameBuffer::kTileSize - 1)) + FrameBuffer::kTileSize)
+        {
+            const int tileRight = std::min((tileLeft | (FrameBuffer::kTileSize - 1)) + 1, right);
+            if (!frameBuffer->IsAreaKept(tileLeft, bandTop, tileRight - 1, bandBottom - 1))
+            {
+                spanLeft = std::min(spanLeft, tileLeft);
+                spanRight = tileRight;
+            }
+        }
+        std::fill(rowLeft.begin() + (bandTop - top), rowLeft.begin() + (bandBottom - top), spanLeft);
+        std::fill(rowRight.begin() + (bandTop - top), rowRight.begin() + (bandBottom - top), spanRight);
+    }
+    const float invWidth = 1.0f / std::max(areaRight - areaLeft, 1.0f);
+    const float invHeight = 1.0f / std::max(areaBottom - areaTop, 1.0f);
+    std::vector<uint32_t> image(static_cast<size_t>(rowWidth) * rowCount);
+
+    // Threads pull rows from a shared counter so slow rows, like the inside of the Mandelbrot set, balance out
+    std::atomic<int> nextRow = 0;
+    auto worker = [&]()
+    {
+        std::vector<__m128> stack(static_cast<size_t>(stackDepth) * kGroupCount);
+        for (int row = nextRow++; row < rowCount; row = nextRow++)
+        {
+            if (rowLeft[row] < rowRight[row])
+            {
+                ShadeRow(channels, stack.data(), top + row, rowLeft[row], rowRight[row], areaLeft, areaTop, invWidth, invHeight, &image[static_cast<size_t>(row) * rowWidth + (rowLeft[row] - left)]);
+            }
+        }
+    };
+
+    mWorkers.Run(worker, static_cast<uint32_t>(rowCount));
+
+    for (int row = 0; row < rowCount; ++row)
+    {
+        if (rowLeft[row] < rowRight[row])
+        {
+            frameBuffer->WriteSpan(top + row, rowLeft[row], rowRight[row] - 1, &image[static_cast<size_t>(row) * rowWidth + (rowLeft[row] - left)]);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Command.h"
+#include "ShadeProgram.h"
+#include "WorkerPool.h"
+
+#include <map>
+
+class CmdShade : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "Shade";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "Shade(\"r\", \"g\", \"b\")\n"
+            "Shade(\"r\", \"g\", \"b\", left, top, right, bottom)\n"
+            "\n"
+            "-fills every pixel of the target, or of the rectangle, with colors from three expressions\n"
+            "-expressions read x, y in pixels, u, v from 0 to 1 across the area, pi and $vars\n"
+            "-operators + - * / % and sin cos sqrt abs floor fract min max step mix clamp\n"
+            "-noise(x, y) gives value noise, mandel(x, y, iterations) the Mandelbrot escape fraction\n"
+            "-pixels are overwritten, rows are shared between threads";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+
+private:
+    const ShadeProgram* GetProgram(const std::string& expression);
+
+    // Compiled once per distinct expression, scripts rerun every frame
+    std::map<std::string, ShadeProgram> mPrograms;
+    // Rows are shaded on threads kept between calls, Shade can run several times a frame
+    WorkerPool mWorkers;
+};
@@ -0,0 +1,20 @@
+#include "CmdTexVertex.h"
+#include "PrimitivesManager.h"
+#include "VariableCache.h"
+
+bool CmdTexVertex::Execute(const std::vector<std::string>& params)
+{
+    // Always a position and texture coordinates, whether a texture is set or not
+    if (params.size() != 5)
+    {
+        return false;
+    }
+
+    VariableCache* vc = VariableCache::Get();
+    Vertex vertex;
+    vertex.pos = { vc->GetFloat(params[0]), vc->GetFloat(params[1]), vc->GetFloat(params[2]) };
+    vertex.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+    vertex.uv = { vc->GetFloat(params[3]), vc->GetFloat(params[4]) };
+    PrimitivesManager::Get()->AddVertex(vertex);
+    return true;
+}
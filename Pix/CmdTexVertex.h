@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Command.h"
+
+class CmdTexVertex : public Command
+{
+public:
+    const char* GetName() override
+    {
+        return "TexVertex";
+    }
+    const char* GetDescription() override
+    {
+        return
+            "TexVertex(x, y, z, u, v)\n"
+            "\n"
+            "-adds a white vertex with texture coordinates to the primitives manager\n"
+            "-Vertex(x, y, z, r, g, b, u, v) also sets a color";
+    }
+    bool Execute(const std::vector<std::string>& params) override;
+};
@@ -6,7 +6,8 @@ bool CmdVertex::Execute(const std::vector<std::string>& params)
 {
     VariableCache* vc = VariableCache::Get();
     float x, y, z = 0.0f;
-    float r, g, b = 1.0f;
+    float r = 1.0f, g = 1.0f, b = 1.0f, a = 1.0f;
+    float u = 0.0f, v = 0.0f;
 
     if (params.size() == 2)
     {
@@ -36,14 +37,48 @@ bool CmdVertex::Execute(const std::vector<std::string>& params)
         g = vc->GetFloat(params[4]);
         b = vc->GetFloat(params[5]);
     }
+    else if (params.size() == 7)
+    {
+        x = vc->GetFloat(params[0]);
+        y = vc->GetFloat(params[1]);
+        z = vc->GetFloat(params[2]);
+        r = vc->GetFloat(params[3]);
+        g = vc->GetFloat(params[4]);
+        b = vc->GetFloat(params[5]);
+        a = vc->GetFloat(params[6]);
+    }
+    else if (params.size() == 8)
+    {
+        x = vc->GetFloat(params[0]);
+        y = vc->GetFloat(params[1]);
+        z = vc->GetFloat(params[2]);
+        r = vc->GetFloat(params[3]);
+        g = vc->GetFloat(params[4]);
+        b = vc->GetFloat(params[5]);
+        u = vc->GetFloat(params[6]);
+        v = vc->GetFloat(params[7]);
+    }
+    else if (params.size() == 9)
+    {
+        x = vc->GetFloat(params[0]);
+        y = vc->GetFloat(params[1]);
+        z = vc->GetFloat(params[2]);
+        r = vc->GetFloat(params[3]);
+        g = vc->GetFloat(params[4]);
+        b = vc->GetFloat(params[5]);
+        a = vc->GetFloat(params[6]);
+        u = vc->GetFloat(params[7]);
+        v = vc->GetFloat(params[8]);
+    }
     else
     {
         return false;
     }
 
-    Vertex v;
-    v.pos = { x, y, z };
-    v.color = { r, g, b, 1.0f };
-    PrimitivesManager::Get()->AddVertex(v);
+    Vertex vertex;
+    vertex.pos = { x, y, z };
+    vertex.color = { r, g, b, a };
+    vertex.uv = { u, v };
+    PrimitivesManager::Get()->AddVertex(vertex);
     return true;
 }
\ No newline at end of file
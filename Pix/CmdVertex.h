@@ -16,8 +16,12 @@ public:
             "Vertex(x, y, z)\n"
             "Vertex(x, y, r, g, b)\n"
             "Vertex(x, y, z, r, g, b)\n"
+            "Vertex(x, y, z, r, g, b, a)\n"
+            "Vertex(x, y, z, r, g, b, u, v)\n"
+            "Vertex(x, y, z, r, g, b, a, u, v)\n"
             "\n"
-            "-adds vertex to the primitives manager before render";
+            "-adds vertex to the primitives manager before render\n"
+            "-TexVertex(x, y, z, u, v) takes texture coordinates without a color";
     }
     bool Execute(const std::vector<std::string>& params) override;
 };
\ No newline at end of file
@@ -1,12 +1,44 @@
 #include "CommandDictionary.h"
 
 #include "CmdDrawPixel.h"
+#include "CmdFloodFill.h"
+#include "CmdDrawCircle.h"
+#include "CmdDrawEllipse.h"
+#include "CmdMoveTo.h"
+#include "CmdLineTo.h"
+#include "CmdQuadTo.h"
+#include "CmdCubicTo.h"
+#include "CmdFillPath.h"
 #include "CmdSetResolution.h"
 #include "CmdVarFloat.h"
 #include "CmdSetColor.h"
+#include "CmdSetTexture.h"
+#include "CmdSetTextureFilter.h"
+#include "CmdSetMemoryLayout.h"
+#include "CmdSetBlendMode.h"
+#include "CmdSetFillMode.h"
+#include "CmdSetShadeMode.h"
+#include "CmdSetDepthTest.h"
+#include "CmdSetLineWidth.h"
+#include "CmdSetLineSmooth.h"
+#include "CmdSetMultisample.h"
+#include "CmdSetFrameBudget.h"
+#include "CmdSetShader.h"
+#include "CmdShade.h"
 #include "CmdBeginDraw.h"
 #include "CmdEndDraw.h"
 #include "CmdVertex.h"
+#include "CmdTexVertex.h"
+#include "CmdIndex.h"
+#include "CmdRestartStrip.h"
+#include "CmdBeginMesh.h"
+#include "CmdEndMesh.h"
+#include "CmdDrawMesh.h"
+#include "CmdInstance.h"
+#include "CmdDrawInstanced.h"
+#include "CmdSetWorld.h"
+#include "CmdSetView.h"
+#include "CmdSetProjection.h"
 
 CommandDictionary* CommandDictionary::Get()
 {
@@ -26,12 +58,52 @@ CommandDictionary::CommandDictionary()
 
 	// Rasterization commands
 	RegisterCommand<CmdDrawPixel>();
+	RegisterCommand<CmdFloodFill>();
+	RegisterCommand<CmdDrawCircle>();
+	RegisterCommand<CmdDrawEllipse>();
 	RegisterCommand<CmdSetColor>();
+	RegisterCommand<CmdSetTexture>();
+	RegisterCommand<CmdSetTextureFilter>();
+	RegisterCommand<CmdSetMemoryLayout>();
+	RegisterCommand<CmdSetBlendMode>();
+	RegisterCommand<CmdSetFillMode>();
+	RegisterCommand<CmdSetShadeMode>();
+	RegisterCommand<CmdSetDepthTest>();
+	RegisterCommand<CmdSetLineWidth>();
+	RegisterCommand<CmdSetLineSmooth>();
+	RegisterCommand<CmdSetMultisample>();
+	RegisterCommand<CmdSetFrameBudget>();
+	RegisterCommand<CmdSetShader>();
+
+	// Procedural commands
+	RegisterCommand<CmdShade>();
+
+	// Path commands
+	RegisterCommand<CmdMoveTo>();
+	RegisterCommand<CmdLineTo>();
+	RegisterCommand<CmdQuadTo>();
+	RegisterCommand<CmdCubicTo>();
+	RegisterCommand<CmdFillPath>();
 
 	// Primitives commands
 	RegisterCommand<CmdBeginDraw>();
 	RegisterCommand<CmdEndDraw>();
 	RegisterCommand<CmdVertex>();
+	RegisterCommand<CmdTexVertex>();
+	RegisterCommand<CmdIndex>();
+	RegisterCommand<CmdRestartStrip>();
+
+	// Mesh commands
+	RegisterCommand<CmdBeginMesh>();
+	RegisterCommand<CmdEndMesh>();
+	RegisterCommand<CmdDrawMesh>();
+	RegisterCommand<CmdInstance>();
+	RegisterCommand<CmdDrawInstanced>();
+
+	// Transform commands
+	RegisterCommand<CmdSetWorld>();
+	RegisterCommand<CmdSetView>();
+	RegisterCommand<CmdSetProjection>();
 
 }
 
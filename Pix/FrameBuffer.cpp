@@ -0,0 +1,1191 @@
+#include "FrameBuffer.h"
+
+#include <XEngine.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    // Nothing drawn. Fully transparent black is never visible so it doubles as the empty value.
+    constexpr uint32_t kEmptyPixel = 0;
+
+    uint32_t PackColor(const X::Color& color)
+    {
+        auto toByte = [](float c) { return static_cast<uint32_t>(std::min(std::max(c, 0.0f), 1.0f) * 255.0f + 0.5f); };
+        return toByte(color.r) | (toByte(color.g) << 8) | (toByte(color.b) << 16) | (toByte(color.a) << 24);
+    }
+
+    // x / 255 rounded to nearest, exact for every product of two bytes
+    __m128i Div255(__m128i x)
+    {
+        return _mm_mulhi_epu16(_mm_add_epi16(x, _mm_set1_epi16(128)), _mm_set1_epi16(257));
+    }
+
+    // Scale each channel by the pixel's alpha, alpha itself is kept. Pixels are 16 bits per channel, 2 per register.
+    __m128i Premultiply(__m128i color)
+    {
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(color, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm_or_si128(_mm_and_si128(alpha, _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0)), _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255));
+        return Div255(_mm_mullo_epi16(color, alpha));
+    }
+
+    // src + dst * (255 - src alpha) / 255 with a premultiplied source, 16 bits per channel
+    __m128i Over(__m128i src, __m128i dst)
+    {
+        const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+        return _mm_add_epi16(src, Div255(_mm_mullo_epi16(dst, inverse)));
+    }
+
+    // dst * (src * a + 255 - a) / 255, src alpha becomes 255 after premultiply so dst alpha is kept
+    __m128i Modulate(__m128i src, __m128i dst)
+    {
+        const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        const __m128i factor = _mm_add_epi16(Premultiply(src), _mm_sub_epi16(_mm_set1_epi16(255), alpha));
+        return Div255(_mm_mullo_epi16(dst, factor));
+    }
+
+    // Blend 4 RGBA8 pixels in 8 bit fixed point, each half is widened to 16 bits for the products
+    template <BlendMode Mode>
+    __m128i BlendPixels(__m128i src, __m128i dst)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i srcLo = _mm_unpacklo_epi8(src, zero);
+        const __m128i srcHi = _mm_unpackhi_epi8(src, zero);
+        const __m128i dstLo = _mm_unpacklo_epi8(dst, zero);
+        const __m128i dstHi = _mm_unpackhi_epi8(dst, zero);
+        if constexpr (Mode == BlendMode::Alpha)
+        {
+            return _mm_packus_epi16(Over(Premultiply(srcLo), dstLo), Over(Premultiply(srcHi), dstHi));
+        }
+        else if constexpr (Mode == BlendMode::Additive)
+        {
+            return _mm_adds_epu8(dst, _mm_packus_epi16(Premultiply(srcLo), Premultiply(srcHi)));
+        }
+        else if constexpr (Mode == BlendMode::Multiply)
+        {
+            return _mm_packus_epi16(Modulate(srcLo, dstLo), Modulate(srcHi, dstHi));
+        }
+        else if constexpr (Mode == BlendMode::Premultiplied)
+        {
+            return _mm_packus_epi16(Over(srcLo, dstLo), Over(srcHi, dstHi));
+        }
+        else
+        {
+            return src;
+        }
+    }
+
+    // Alpha and premultiplied blends of fully opaque pixels are plain overwrites
+    bool IsOpaque(__m128i pixels)
+    {
+        const __m128i alpha = _mm_or_si128(pixels, _mm_set1_epi32(0x00ffffff));
+        return _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, _mm_set1_epi32(-1))) == 0xffff;
+    }
+
+    constexpr float kFarDepth = std::numeric_limits<float>::max();
+
+    constexpr int kLaneCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+    // mTileKept values, the second for tiles an earlier pass of the same frame drew
+    constexpr uint8_t kKeptFromLastFrame = 1;
+    constexpr uint8_t kKeptFromFirstPass = 2;
+    // mTileChanges once the draws of a tile changed over each of the last two frames
+    constexpr uint8_t kChangedTwice = 3;
+
+    float MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Sample state of a pixel, 0 while it is a single color
+    constexpr uint8_t kSamplesApart = 1;
+    // Its samples also hold depths of their own
+    constexpr uint8_t kDepthApart = 2;
+
+    // Standard Direct3D patterns, no two samples share a row or a column
+    constexpr FrameBuffer::SampleOffset kOneSample[] = { { 0, 0 } };
+    constexpr FrameBuffer::SampleOffset kFourSamples[] = { { -2, -6 }, { 6, -2 }, { -6, 2 }, { 2, 6 } };
+    constexpr FrameBuffer::SampleOffset kEightSamples[] = { { 1, -3 }, { -1, 3 }, { 5, 1 }, { -3, -5 }, { -5, 5 }, { -7, -1 }, { 3, 7 }, { 7, -7 } };
+
+    // Rounded mean of 4 or 8 packed samples, summed 16 bits per channel
+    uint32_t AverageSamples(const uint32_t* samples, uint32_t count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum = zero;
+        for (uint32_t i = 0; i < count; i += 4)
+        {
+            const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+            sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_unpacklo_epi8(group, zero), _mm_unpackhi_epi8(group, zero)));
+        }
+        sum = _mm_add_epi16(sum, _mm_srli_si128(sum, 8));
+        sum = _mm_add_epi16(sum, _mm_set1_epi16(static_cast<short>(count / 2)));
+        sum = _mm_srl_epi16(sum, _mm_cvtsi32_si128(count == 8 ? 3 : 2));
+        return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(sum, sum)));
+    }
+}
+
+FrameBuffer* FrameBuffer::Get()
+{
+    static FrameBuffer sInstance;
+    return &sInstance;
+}
+
+void FrameBuffer::Initialize(uint32_t width, uint32_t height)
+{
+    if (width == mLayout.GetWidth() && height == mLayout.GetHeight())
+    {
+        return;
+    }
+
+    mLayout = SurfaceLayout(mLayout.GetLayout(), width, height);
+    mPixels.assign(mLayout.GetSize(), kEmptyPixel);
+    mDepth.assign(mLayout.GetSize(), kFarDepth);
+    mDepthWritten = false;
+    mSampleState.assign(mLayout.GetSize(), 0);
+    mSampleBlocks.assign(mLayout.GetSize(), 0);
+    mSampleBlockCount = 0;
+    ResetTiles();
+}
+
+void FrameBuffer::SetLayout(MemoryLayout layout)
+{
+    if (layout == mLayout.GetLayout())
+    {
+        return;
+    }
+
+    const SurfaceLayout newLayout(layout, mLayout.GetWidth(), mLayout.GetHeight());
+    std::vector<uint32_t> pixels(newLayout.GetSize(), kEmptyPixel);
+    std::vector<float> depth(newLayout.GetSize(), kFarDepth);
+    // Sample blocks stay where they are in the pool, only the pixels they belong to move
+    std::vector<uint8_t> sampleState(newLayout.GetSize(), 0);
+    std::vector<uint32_t> sampleBlocks(newLayout.GetSize(), 0);
+    for (uint32_t y = 0; y < mLayout.GetHeight(); ++y)
+    {
+        for (uint32_t x = 0; x < mLayout.GetWidth(); ++x)
+        {
+            const uint32_t from = mLayout.GetIndex(x, y);
+            const uint32_t to = newLayout.GetIndex(x, y);
+            pixels[to] = mPixels[from];
+            depth[to] = mDepth[from];
+            if (mSampleState[from] != 0)
+            {
+                sampleState[to] = mSampleState[from];
+                sampleBlocks[to] = mSampleBlocks[from];
+                mSampleBlockPixels[mSampleBlocks[from]] = to;
+            }
+        }
+    }
+
+    mPixels = std::move(pixels);
+    mDepth = std::move(depth);
+    mSampleState = std::move(sampleState);
+    mSampleBlocks = std::move(sampleBlocks);
+    mLayout = newLayout;
+}
+
+void FrameBuffer::Clear()
+{
+    if (!mContinuingFrame)
+    {
+        // Tiles left stale by the last frame are due, and tiles that changed over each of the last two frames
+        // are drawn right away, they are most likely animating. With a budget the prediction is left out,
+        // a tile that turns out the same would take a share of the budget for nothing.
+        // Everything shows the last frame until the pass that draws it, then start hashing this one.
+        const bool predict = mFrameBudget <= 0.0f;
+        mStaleTileCount = 0;
+        for (size_t i = 0; i < mTileKept.size(); ++i)
+        {
+            mTileStale[i] |= mTilesInvalidated || (predict && mTileChanges[i] == kChangedTwice) ? 1 : 0;
+            mStaleTileCount += mTileStale[i];
+            mTileKept[i] = kKeptFromLastFrame;
+        }
+        mLastTileHashes.swap(mTileHashes);
+        mFrameStart = std::chrono::steady_clock::now();
+        mTilesDrawn = 0;
+        mPixelsWritten = 0;
+    }
+    // The first pass goes by the last frame's budget, the script sets this one's as it runs.
+    // After a draw that reads other tiles, the next pass draws all of them whatever the budget.
+    SelectPassTiles(mTilesInvalidated);
+    mTilesInvalidated = false;
+    if (!mContinuingFrame)
+    {
+        mFrameBudget = 0.0f;
+    }
+    mPassStart = std::chrono::steady_clock::now();
+    std::fill(mTileHashes.begin(), mTileHashes.end(), kInputHashSeed);
+
+    if (mKeptTileCount == 0)
+    {
+        std::fill(mPixels.begin(), mPixels.end(), kEmptyPixel);
+        if (mDepthWritten)
+        {
+            std::fill(mDepth.begin(), mDepth.end(), kFarDepth);
+            mDepthWritten = false;
+        }
+    }
+    else
+    {
+        // Depth stays marked as written, kept tiles may still hold some for when they are drawn again
+        for (uint32_t i = 0; i < GetTileCount(); ++i)
+        {
+            if (mTileKept[i] == 0)
+            {
+                ClearTile(i, mDepthWritten);
+            }
+        }
+    }
+    mSampleCoverage = nullptr;
+    ResetSamples();
+    mSampleCount = 1;
+}
+
+uint64_t FrameBuffer::HashInput(const void* data, size_t size, uint64_t hash)
+{
+    // 8 bytes at a time, multiplied and folded so every input bit reaches the low bits
+    constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (; size >= 8; size -= 8, bytes += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        hash = (hash ^ word) * kMultiplier;
+        hash ^= hash >> 29;
+    }
+    for (; size > 0; --size, ++bytes)
+    {
+        hash = (hash ^ *bytes) * kMultiplier;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+bool FrameBuffer::AddTileInput(int minX, int minY, int maxX, int maxY, uint64_t hash)
+{
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, static_cast<int>(mLayout.GetWidth()) - 1);
+    maxY = std::min(maxY, static_cast<int>(mLayout.GetHeight()) - 1);
+    if (minX > maxX || minY > maxY)
+    {
+        return false;
+    }
+
+    // Chained in draw order, blending and depth make the order matter
+    bool drawn = false;
+    for (int tileY = minY >> kTileShift; tileY <= maxY >> kTileShift; ++tileY)
+    {
+        for (int tileX = minX >> kTileShift; tileX <= maxX >> kTileShift; ++tileX)
+        {
+            const uint32_t tile = tileY * mTileColumns + tileX;
+            mTileHashes[tile] = HashInput(&hash, sizeof(hash), mTileHashes[tile]);
+            drawn |= mTileKept[tile] == 0;
+        }
+    }
+    return drawn;
+}
+
+bool FrameBuffer::IsAreaKept(int minX, int minY, int maxX, int maxY) const
+{
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, static_cast<int>(mLayout.GetWidth()) - 1);
+    maxY = std::min(maxY, static_cast<int>(mLayout.GetHeight()) - 1);
+    if (mKeptTileCount == 0)
+    {
+        return false;
+    }
+    if (minX > maxX || minY > maxY)
+    {
+        return true;
+    }
+
+    for (int tileY = minY >> kTileShift; tileY <= maxY >> kTileShift; ++tileY)
+    {
+        for (int tileX = minX >> kTileShift; tileX <= maxX >> kTileShift; ++tileX)
+        {
+            if (mTileKept[tileY * mTileColumns + tileX] == 0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void FrameBuffer::InvalidateTiles()
+{
+    mTilesInvalidated = true;
+}
+
+void FrameBuffer::SetFrameBudget(float milliseconds)
+{
+    mFrameBudget = std::max(milliseconds, 0.0f);
+}
+
+bool FrameBuffer::FinishPass()
+{
+    // A tile is right when its draws hash the same as the ones it was last drawn with.
+    // After a draw that reads other tiles, like a flood fill, nothing is right unless this pass drew every tile.
+    const bool invalidated = mTilesInvalidated && mKeptTileCount != 0;
+    mStaleTileCount = 0;
+    for (size_t i = 0; i < mTileKept.size(); ++i)
+    {
+        if (mTileKept[i] == 0)
+        {
+            mDrawnTileHashes[i] = mTileHashes[i];
+            mTileKept[i] = kKeptFromFirstPass;
+        }
+        mTileStale[i] = mTileHashes[i] != mDrawnTileHashes[i] || invalidated ? 1 : 0;
+        mStaleTileCount += mTileStale[i];
+    }
+
+    // Time per tile drawn, the script's own share included. It rises at once and falls slowly,
+    // so a pass after one over cheap tiles does not take on too many heavy ones.
+    if (mFrameBudget > 0.0f && mPassTileCount > 0 && !invalidated)
+    {
+        const float tileTime = MillisecondsSince(mPassStart) / static_cast<float>(mPassTileCount);
+        mTileTime = tileTime > mTileTime ? tileTime : mTileTime * 0.75f + tileTime * 0.25f;
+    }
+
+    // Without a budget the frame is finished, with one it stops once not even a tile fits and carries on next frame
+    const bool outOfTime = mFrameBudget > 0.0f && MillisecondsSince(mFrameStart) + mTileTime > mFrameBudget;
+    if (mStaleTileCount == 0 || (outOfTime && !invalidated))
+    {
+        mContinuingFrame = false;
+        for (size_t i = 0; i < mTileChanges.size(); ++i)
+        {
+            const uint8_t changed = mTileHashes[i] != mLastTileHashes[i] ? 1 : 0;
+            mTileChanges[i] = static_cast<uint8_t>(((mTileChanges[i] << 1) | changed) & kChangedTwice);
+        }
+        return true;
+    }
+
+    // The next pass keeps what this one drew, so it needs its final colors
+    Resolve();
+    mContinuingFrame = true;
+    return false;
+}
+
+void FrameBuffer::SelectPassTiles(bool drawAll)
+{
+    // As many stale tiles as fit what is left of the budget, a row of them while their cost is unknown.
+    // They go in scan order from where the last pass stopped, so a sweep that takes several frames finishes.
+    const uint32_t tileCount = GetTileCount();
+    uint32_t limit = tileCount;
+    if (!drawAll && mFrameBudget > 0.0f)
+    {
+        const float timeLeft = mFrameBudget - MillisecondsSince(mFrameStart);
+        const float fit = mTileTime > 0.0f ? timeLeft / mTileTime : static_cast<float>(mTileColumns);
+        limit = static_cast<uint32_t>(std::clamp(fit, 1.0f, static_cast<float>(std::max(tileCount, 1u))));
+    }
+    mPassTileCount = 0;
+    for (uint32_t n = 0; n < tileCount && mPassTileCount < limit; ++n)
+    {
+        const uint32_t tile = mNextTile + n < tileCount ? mNextTile + n : mNextTile + n - tileCount;
+        if (drawAll || mTileStale[tile] != 0)
+        {
+            mTileKept[tile] = 0;
+            ++mPassTileCount;
+            if (mPassTileCount == limit)
+            {
+                mNextTile = tile + 1 < tileCount ? tile + 1 : 0;
+            }
+        }
+    }
+    mKeptTileCount = tileCount - mPassTileCount;
+    mTilesDrawn += mPassTileCount;
+}
+
+void FrameBuffer::ResetTiles()
+{
+    mTileColumns = (mLayout.GetWidth() + kTileSize - 1) >> kTileShift;
+    mTileRows = (mLayout.GetHeight() + kTileSize - 1) >> kTileShift;
+    const size_t count = static_cast<size_t>(mTileColumns) * mTileRows;
+    mTileHashes.assign(count, kInputHashSeed);
+    mLastTileHashes.assign(count, kInputHashSeed);
+    mDrawnTileHashes.assign(count, kInputHashSeed);
+    mTileChanges.assign(count, 0);
+    mTileKept.assign(count, 0);
+    mTileStale.assign(count, 1);
+    mKeptTileCount = 0;
+    mStaleTileCount = static_cast<uint32_t>(count);
+    mTilesDrawn = static_cast<uint32_t>(count);
+    mPassTileCount = 0;
+    mTileTime = 0.0f;
+    mNextTile = 0;
+    mTilesInvalidated = false;
+    mContinuingFrame = false;
+    // Forces a full upload on the next Present
+    mPresentPixels.clear();
+}
+
+void FrameBuffer::ClearTile(uint32_t tile, bool clearDepth)
+{
+    const uint32_t left = (tile % mTileColumns) << kTileShift;
+    const uint32_t top = (tile / mTileColumns) << kTileShift;
+    const uint32_t right = std::min(left + kTileSize, mLayout.GetWidth());
+    const uint32_t bottom = std::min(top + kTileSize, mLayout.GetHeight());
+    for (uint32_t y = top; y < bottom; ++y)
+    {
+        if (mLayout.GetLayout() == MemoryLayout::Linear)
+        {
+            const uint32_t start = y * mLayout.GetWidth() + left;
+            std::fill_n(mPixels.data() + start, right - left, kEmptyPixel);
+            if (clearDepth)
+            {
+                std::fill_n(mDepth.data() + start, right - left, kFarDepth);
+            }
+            continue;
+        }
+        for (uint32_t x = left; x < right; ++x)
+        {
+            const uint32_t index = mLayout.GetIndex(x, y);
+            mPixels[index] = kEmptyPixel;
+            if (clearDepth)
+            {
+                mDepth[index] = kFarDepth;
+            }
+        }
+    }
+}
+
+int FrameBuffer::GetWritableLanes(int x, int y) const
+{
+    const uint8_t* kept = &mTileKept[static_cast<size_t>(y >> kTileShift) * mTileColumns];
+    // Lanes off the buffer are already masked, a group of 4 straddles at most two tiles
+    const int first = std::max(x, 0) >> kTileShift;
+    const int last = std::min((x + 3) >> kTileShift, static_cast<int>(mTileColumns) - 1);
+    if (first >= last)
+    {
+        return kept[first] != 0 ? 0 : 0xf;
+    }
+    const int firstLanes = (1 << ((last << kTileShift) - x)) - 1;
+    return (kept[first] != 0 ? 0 : firstLanes) | (kept[last] != 0 ? 0 : 0xf & ~firstLanes);
+}
+
+bool FrameBuffer::NextWritableRun(int y, int& startX, int& endX) const
+{
+    if (startX > endX)
+    {
+        return false;
+    }
+
+    const uint8_t* kept = &mTileKept[static_cast<size_t>(y >> kTileShift) * mTileColumns];
+    const int lastTile = endX >> kTileShift;
+    int tile = startX >> kTileShift;
+    while (tile <= lastTile && kept[tile] != 0)
+    {
+        ++tile;
+    }
+    if (tile > lastTile)
+    {
+        return false;
+    }
+    int runEndTile = tile;
+    while (runEndTile < lastTile && kept[runEndTile + 1] == 0)
+    {
+        ++runEndTile;
+    }
+    startX = std::max(startX, tile << kTileShift);
+    endX = std::min(endX, ((runEndTile + 1) << kTileShift) - 1);
+    return true;
+}
+
+void FrameBuffer::SetSampleCount(uint32_t count)
+{
+    if (count != 4 && count != 8)
+    {
+        count = 1;
+    }
+    if (count == mSampleCount)
+    {
+        return;
+    }
+
+    // Pixels drawn so far keep their look as single colors
+    Resolve();
+    mSampleCount = count;
+    ResetSamples();
+}
+
+const FrameBuffer::SampleOffset* FrameBuffer::GetSampleOffsets() const
+{
+    switch (mSampleCount)
+    {
+    case 4: return kFourSamples;
+    case 8: return kEightSamples;
+    default: return kOneSample;
+    }
+}
+
+void FrameBuffer::SetSampleCoverage(const uint8_t* coverage, int startX)
+{
+    mSampleCoverage = coverage;
+    mSampleCoverageX = startX;
+}
+
+void FrameBuffer::ResetSamples()
+{
+    // Only pixels that were handed a block can have samples apart
+    for (uint32_t i = 0; i < mSampleBlockCount; ++i)
+    {
+        mSampleState[mSampleBlockPixels[i]] = 0;
+    }
+    mSampleBlockCount = 0;
+}
+
+void FrameBuffer::Resolve()
+{
+    // Walk the blocks instead of the pixels, most pixels were only ever fully covered and already hold their color.
+    // A block whose pixel went back to a single color, or took a newer block, is skipped.
+    for (uint32_t i = 0; i < mSampleBlockCount; ++i)
+    {
+        const uint32_t pixel = mSampleBlockPixels[i];
+        if (mSampleState[pixel] != 0 && mSampleBlocks[pixel] == i)
+        {
+            mPixels[pixel] = AverageSamples(&mSamples[i * mSampleCount], mSampleCount);
+        }
+    }
+}
+
+void FrameBuffer::SetPixel(int x, int y, const X::Color& color, BlendMode mode)
+{
+    const __m128i pixel = _mm_cvtsi32_si128(static_cast<int>(PackColor(color)));
+    const __m128 depth = _mm_setzero_ps();
+    switch (mode)
+    {
+    case BlendMode::Alpha:
+        WritePixels<BlendMode::Alpha, false>(x, y, 1, pixel, depth);
+        break;
+    case BlendMode::Additive:
+        WritePixels<BlendMode::Additive, false>(x, y, 1, pixel, depth);
+        break;
+    case BlendMode::Multiply:
+        WritePixels<BlendMode::Multiply, false>(x, y, 1, pixel, depth);
+        break;
+    case BlendMode::Premultiplied:
+        WritePixels<BlendMode::Premultiplied, false>(x, y, 1, pixel, depth);
+        break;
+    default:
+        WritePixels<BlendMode::Opaque, false>(x, y, 1, pixel, depth);
+        break;
+    }
+}
+
+template <BlendMode Mode, bool DepthTest>
+void FrameBuffer::WritePixels(int x, int y, int mask, __m128i pixels, __m128 depth)
+{
+    // Drop lanes outside the buffer
+    const int width = static_cast<int>(mLayout.GetWidth());
+    if (static_cast<uint32_t>(y) >= mLayout.GetHeight())
+    {
+        return;
+    }
+    if (x < 0 || x + 4 > width)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            if (x + i < 0 || x + i >= width)
+            {
+                mask &= ~(1 << i);
+            }
+        }
+    }
+    // Tiles kept from the last frame already hold their pixels
+    if (mKeptTileCount != 0)
+    {
+        mask &= GetWritableLanes(x, y);
+    }
+    if (mask == 0)
+    {
+        return;
+    }
+
+    // Partly covered pixels and ones that already hold samples apart go sample by sample, the rest as single colors below
+    if (mSampleCount > 1)
+    {
+        mask = WriteSampleLanes<Mode, DepthTest>(x, y, mask, pixels, depth);
+        if (mask == 0)
+        {
+            return;
+        }
+    }
+
+    // A linear row group inside the buffer is contiguous, unused lanes are masked on store.
+    // Anything else goes through per lane indices.
+    const bool contiguous = mLayout.GetLayout() == MemoryLayout::Linear && x >= 0 && x + 4 <= width;
+    const uint32_t base = static_cast<uint32_t>(y * width + x);
+    alignas(16) uint32_t index[4];
+    if (!contiguous)
+    {
+        const __m128i laneX = _mm_add_epi32(_mm_set1_epi32(x), _mm_setr_epi32(0, 1, 2, 3));
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), mLayout.GetIndex4(laneX, _mm_set1_epi32(y)));
+    }
+
+    if constexpr (DepthTest)
+    {
+        alignas(16) float stored[4] = { kFarDepth, kFarDepth, kFarDepth, kFarDepth };
+        if (contiguous)
+        {
+            _mm_store_ps(stored, _mm_loadu_ps(&mDepth[base]));
+        }
+        else
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                if (mask & (1 << i))
+                {
+                    stored[i] = mDepth[index[i]];
+                }
+            }
+        }
+
+        const int passed = mask & _mm_movemask_ps(_mm_cmplt_ps(depth, _mm_load_ps(stored)));
+        if (passed == 0)
+        {
+            return;
+        }
+
+        alignas(16) float newDepth[4];
+        _mm_store_ps(newDepth, depth);
+        for (int i = 0; i < 4; ++i)
+        {
+            if (passed & (1 << i))
+            {
+                mDepth[contiguous ? base + i : index[i]] = newDepth[i];
+            }
+        }
+        mDepthWritten = true;
+        mask = passed;
+    }
+
+    mPixelsWritten += static_cast<uint32_t>(kLaneCount[mask]);
+
+    // Alpha and premultiplied blends of opaque pixels are plain overwrites
+    bool blend = Mode != BlendMode::Opaque;
+    if constexpr (Mode == BlendMode::Alpha || Mode == BlendMode::Premultiplied)
+    {
+        blend = !IsOpaque(pixels);
+    }
+
+    if (contiguous)
+    {
+        __m128i* target = reinterpret_cast<__m128i*>(&mPixels[base]);
+        if (blend || mask != 0xf)
+        {
+            const __m128i dst = _mm_loadu_si128(target);
+            if (blend)
+            {
+                pixels = BlendPixels<Mode>(pixels, dst);
+            }
+            const __m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+            const __m128i keep = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(mask), laneBits), laneBits);
+            pixels = _mm_or_si128(_mm_and_si128(keep, pixels), _mm_andnot_si128(keep, dst));
+        }
+        _mm_storeu_si128(target, pixels);
+        return;
+    }
+
+    alignas(16) uint32_t dst[4] = {};
+    if (blend)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            if (mask & (1 << i))
+            {
+                dst[i] = mPixels[index[i]];
+            }
+        }
+        pixels = BlendPixels<Mode>(pixels, _mm_load_si128(reinterpret_cast<const __m128i*>(dst)));
+    }
+
+    alignas(16) uint32_t src[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(src), pixels);
+    for (int i = 0; i < 4; ++i)
+    {
+        if (mask & (1 << i))
+        {
+            mPixels[index[i]] = src[i];
+        }
+    }
+}
+
+template <BlendMode Mode, bool DepthTest>
+int FrameBuffer::WriteSampleLanes(int x, int y, int mask, __m128i pixels, __m128 depth)
+{
+    // Coverage and sample state of the 4 lanes, a byte each
+    const uint32_t allSamples = (1u << mSampleCount) - 1;
+    const uint32_t fullCoverage = allSamples * 0x01010101u;
+    uint32_t coverage = fullCoverage;
+    if (mSampleCoverage != nullptr)
+    {
+        memcpy(&coverage, &mSampleCoverage[x - mSampleCoverageX], sizeof(coverage));
+    }
+    const int width = static_cast<int>(mLayout.GetWidth());
+    const bool contiguous = mLayout.GetLayout() == MemoryLayout::Linear && x >= 0 && x + 4 <= width;
+    const uint32_t base = static_cast<uint32_t>(y * width + x);
+    uint32_t state = 0;
+    if (contiguous)
+    {
+        memcpy(&state, &mSampleState[base], sizeof(state));
+        // 4 fully covered single color pixels are the common case
+        if (mask == 0xf && coverage == fullCoverage && state == 0)
+        {
+            return mask;
+        }
+    }
+
+    alignas(16) uint32_t src[4];
+    alignas(16) float srcDepth[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(src), pixels);
+    _mm_store_ps(srcDepth, depth);
+    for (int i = 0; i < 4; ++i)
+    {
+        if ((mask & (1 << i)) == 0)
+        {
+            continue;
+        }
+        const uint32_t index = contiguous ? base + i : mLayout.GetIndex(x + i, y);
+        const uint32_t laneCoverage = (coverage >> (i * 8)) & 0xff;
+        const uint32_t laneState = contiguous ? (state >> (i * 8)) & 0xff : mSampleState[index];
+        if (laneCoverage == allSamples && laneState == 0)
+        {
+            continue;
+        }
+        if (mSampleCount == 4)
+        {
+            WriteSamples<Mode, DepthTest, 4>(index, laneCoverage, src[i], srcDepth[i]);
+        }
+        else
+        {
+            WriteSamples<Mode, DepthTest, 8>(index, laneCoverage, src[i], srcDepth[i]);
+        }
+        mask &= ~(1 << i);
+    }
+    return mask;
+}
+
+template <BlendMode Mode, bool DepthTest, uint32_t SampleCount>
+void FrameBuffer::WriteSamples(uint32_t index, uint32_t coverage, uint32_t pixel, float depth)
+{
+    if (coverage == 0)
+    {
+        return;
+    }
+
+    constexpr uint32_t count = SampleCount;
+    uint8_t& state = mSampleState[index];
+    if (state == 0)
+    {
+        if (mSampleBlockCount == mSampleBlockPixels.size())
+        {
+            const size_t blockCount = std::max<size_t>(mSampleBlockPixels.size() * 2, 1024);
+            mSampleBlockPixels.resize(blockCount);
+            mSamples.resize(blockCount * kMaxSampleCount);
+            mSampleDepth.resize(blockCount * kMaxSampleCount);
+        }
+        mSampleBlockPixels[mSampleBlockCount] = index;
+        mSampleBlocks[index] = mSampleBlockCount++;
+        std::fill_n(&mSamples[mSampleBlocks[index] * count], count, mPixels[index]);
+        state = kSamplesApart;
+    }
+    const uint32_t sampleIndex = mSampleBlocks[index] * count;
+    uint32_t* samples = &mSamples[sampleIndex];
+
+    // Samples share the depth of the pixel's point, so edges are smooth but where triangles cross is not.
+    // Depths are only spread to the samples by the first depth tested write, until then the pixel's depth stands for them.
+    if constexpr (DepthTest)
+    {
+        float* sampleDepth = &mSampleDepth[sampleIndex];
+        if ((state & kDepthApart) == 0)
+        {
+            std::fill_n(sampleDepth, count, mDepth[index]);
+            state |= kDepthApart;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if ((coverage & (1u << i)) != 0 && !(depth < sampleDepth[i]))
+            {
+                coverage &= ~(1u << i);
+            }
+        }
+        if (coverage == 0)
+        {
+            return;
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (coverage & (1u << i))
+            {
+                sampleDepth[i] = depth;
+            }
+        }
+        mDepthWritten = true;
+    }
+
+    ++mPixelsWritten;
+
+    bool overwrite = Mode == BlendMode::Opaque;
+    if constexpr (Mode == BlendMode::Alpha || Mode == BlendMode::Premultiplied)
+    {
+        overwrite = (pixel >> 24) == 0xff;
+    }
+
+    // Overwriting every sample makes the pixel a single color again, its block is left unused until the pool empties.
+    // Without a depth test that only holds when no sample has a depth of its own to lose.
+    if (overwrite && coverage == (1u << count) - 1 && (DepthTest || (state & kDepthApart) == 0))
+    {
+        mPixels[index] = pixel;
+        if constexpr (DepthTest)
+        {
+            mDepth[index] = depth;
+        }
+        state = 0;
+        return;
+    }
+
+    const __m128i src = _mm_set1_epi32(static_cast<int>(pixel));
+    const __m128i laneBits = _mm_setr_epi32(1, 2, 4, 8);
+    for (uint32_t i = 0; i < count; i += 4)
+    {
+        const int groupCoverage = static_cast<int>((coverage >> i) & 0xf);
+        if (groupCoverage == 0)
+        {
+            continue;
+        }
+        __m128i* target = reinterpret_cast<__m128i*>(samples + i);
+        const __m128i dst = _mm_loadu_si128(target);
+        const __m128i blended = overwrite ? src : BlendPixels<Mode>(src, dst);
+        const __m128i keep = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(groupCoverage), laneBits), laneBits);
+        _mm_storeu_si128(target, _mm_or_si128(_mm_and_si128(keep, blended), _mm_andnot_si128(keep, dst)));
+    }
+}
+
+template <BlendMode Mode>
+void FrameBuffer::FillSpan(int y, int startX, int endX, uint32_t pixel)
+{
+    startX = std::max(startX, 0);
+    endX = std::min(endX, static_cast<int>(mLayout.GetWidth()) - 1);
+    if (static_cast<uint32_t>(y) >= mLayout.GetHeight() || startX > endX)
+    {
+        return;
+    }
+
+    if (mKeptTileCount == 0)
+    {
+        FillRun<Mode>(y, startX, endX, pixel);
+        return;
+    }
+    for (int runStart = startX, runEnd = endX; NextWritableRun(y, runStart, runEnd); runStart = runEnd + 1, runEnd = endX)
+    {
+        FillRun<Mode>(y, runStart, runEnd, pixel);
+    }
+}
+
+template <BlendMode Mode>
+void FrameBuffer::FillRun(int y, int startX, int endX, uint32_t pixel)
+{
+    // Opaque linear rows are a plain fill, multisampled ones too when every sample is covered and none has its own depth
+    const bool singleColor = mSampleCount == 1 || (mSampleCoverage == nullptr && !mDepthWritten);
+    if (Mode == BlendMode::Opaque && mLayout.GetLayout() == MemoryLayout::Linear && singleColor)
+    {
+        const int count = endX - startX + 1;
+        const uint32_t start = y * mLayout.GetWidth() + startX;
+        std::fill_n(&mPixels[start], count, pixel);
+        if (mSampleCount > 1)
+        {
+            std::fill_n(&mSampleState[start], count, uint8_t(0));
+        }
+        mPixelsWritten += static_cast<uint32_t>(count);
+        return;
+    }
+
+    const __m128i pixels = _mm_set1_epi32(static_cast<int>(pixel));
+    const __m128 depth = _mm_setzero_ps();
+    for (int x = startX; x <= endX; x += 4)
+    {
+        const int count = std::min(4, endX - x + 1);
+        WritePixels<Mode, false>(x, y, (1 << count) - 1, pixels, depth);
+    }
+}
+
+void FrameBuffer::FillSpan(int y, int startX, int endX, const X::Color& color, BlendMode mode)
+{
+    const uint32_t pixel = PackColor(color);
+    switch (mode)
+    {
+    case BlendMode::Alpha: FillSpan<BlendMode::Alpha>(y, startX, endX, pixel); break;
+    case BlendMode::Additive: FillSpan<BlendMode::Additive>(y, startX, endX, pixel); break;
+    case BlendMode::Multiply: FillSpan<BlendMode::Multiply>(y, startX, endX, pixel); break;
+    case BlendMode::Premultiplied: FillSpan<BlendMode::Premultiplied>(y, startX, endX, pixel); break;
+    default: FillSpan<BlendMode::Opaque>(y, startX, endX, pixel); break;
+    }
+}
+
+void FrameBuffer::WriteSpan(int y, int startX, int endX, const uint32_t* pixels)
+{
+    auto writeRun = [&](int runStart, int runEnd)
+    {
+        const int count = runEnd - runStart + 1;
+        const uint32_t* source = pixels + (runStart - startX);
+        if (mLayout.GetLayout() == MemoryLayout::Linear)
+        {
+            std::copy_n(source, count, &mPixels[y * mLayout.GetWidth() + runStart]);
+            if (mSampleCount > 1)
+            {
+                std::fill_n(&mSampleState[y * mLayout.GetWidth() + runStart], count, uint8_t(0));
+            }
+        }
+        else
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                const uint32_t index = mLayout.GetIndex(runStart + i, y);
+                mPixels[index] = source[i];
+                if (mSampleCount > 1)
+                {
+                    mSampleState[index] = 0;
+                }
+            }
+        }
+        mPixelsWritten += static_cast<uint32_t>(count);
+    };
+
+    if (mKeptTileCount == 0)
+    {
+        writeRun(startX, endX);
+        return;
+    }
+    for (int runStart = startX, runEnd = endX; NextWritableRun(y, runStart, runEnd); runStart = runEnd + 1, runEnd = endX)
+    {
+        writeRun(runStart, runEnd);
+    }
+}
+
+uint32_t FrameBuffer::FloodFill(int x, int y, const X::Color& color, float tolerance, BlendMode mode)
+{
+    const int width = static_cast<int>(mLayout.GetWidth());
+    const int height = static_cast<int>(mLayout.GetHeight());
+    if (x < 0 || x >= width || y < 0 || y >= height)
+    {
+        return 0;
+    }
+
+    // The region can reach any tile, so no tile is known to be unchanged
+    InvalidateTiles();
+
+    // Matching compares the colors pixels show, partly covered ones included
+    Resolve();
+
+    // Filled pixels are tracked apart from their color, so a fill color that still matches is not filled again
+    const uint32_t seed = mPixels[mLayout.GetIndex(x, y)];
+    const int maxDifference = static_cast<int>(std::min(std::max(tolerance, 0.0f), 1.0f) * 255.0f + 0.5f);
+    std::vector<uint8_t> filled(static_cast<size_t>(width) * height, 0);
+    auto matches = [&](int px, int py)
+    {
+        if (filled[py * width + px] != 0)
+        {
+            return false;
+        }
+        const uint32_t pixel = mPixels[mLayout.GetIndex(px, py)];
+        if (maxDifference == 0)
+        {
+            return pixel == seed;
+        }
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            if (std::abs(static_cast<int>((pixel >> shift) & 0xff) - static_cast<int>((seed >> shift) & 0xff)) > maxDifference)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    const uint32_t pixel = PackColor(color);
+    void (FrameBuffer::*fillSpan)(int, int, int, uint32_t) = nullptr;
+    switch (mode)
+    {
+    case BlendMode::Alpha: fillSpan = &FrameBuffer::FillSpan<BlendMode::Alpha>; break;
+    case BlendMode::Additive: fillSpan = &FrameBuffer::FillSpan<BlendMode::Additive>; break;
+    case BlendMode::Multiply: fillSpan = &FrameBuffer::FillSpan<BlendMode::Multiply>; break;
+    case BlendMode::Premultiplied: fillSpan = &FrameBuffer::FillSpan<BlendMode::Premultiplied>; break;
+    default: fillSpan = &FrameBuffer::FillSpan<BlendMode::Opaque>; break;
+    }
+
+    // Each popped seed grows into a whole row span, then the rows above and below get one seed per matching run.
+    // An explicit stack keeps deep regions from overflowing the call stack.
+    struct Seed { int x, y; };
+    std::vector<Seed> stack;
+    stack.push_back({ x, y });
+    uint32_t pixelsFilled = 0;
+    while (!stack.empty())
+    {
+        const Seed current = stack.back();
+        stack.pop_back();
+        if (!matches(current.x, current.y))
+        {
+            continue;
+        }
+
+        int left = current.x;
+        int right = current.x;
+        while (left > 0 && matches(left - 1, current.y))
+        {
+            --left;
+        }
+        while (right < width - 1 && matches(right + 1, current.y))
+        {
+            ++right;
+        }
+        std::fill(&filled[current.y * width + left], &filled[current.y * width + right] + 1, uint8_t(1));
+        (this->*fillSpan)(current.y, left, right, pixel);
+        pixelsFilled += static_cast<uint32_t>(right - left + 1);
+
+        for (int row : { current.y - 1, current.y + 1 })
+        {
+            if (row < 0 || row >= height)
+            {
+                continue;
+            }
+            bool inRun = false;
+            for (int px = left; px <= right; ++px)
+            {
+                const bool match = matches(px, row);
+                if (match && !inRun)
+                {
+                    stack.push_back({ px, row });
+                }
+                inRun = match;
+            }
+        }
+    }
+    return pixelsFilled;
+}
+
+__m128i FrameBuffer::PackColors(__m128 r, __m128 g, __m128 b, __m128 a)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    auto toByte = [&](__m128 c) { return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_max_ps(_mm_min_ps(c, one), zero), scale), half)); };
+    __m128i pixels = toByte(r);
+    pixels = _mm_or_si128(pixels, _mm_slli_epi32(toByte(g), 8));
+    pixels = _mm_or_si128(pixels, _mm_slli_epi32(toByte(b), 16));
+    return _mm_or_si128(pixels, _mm_slli_epi32(toByte(a), 24));
+}
+
+uint32_t FrameBuffer::Present()
+{
+    const uint32_t width = mLayout.GetWidth();
+    const uint32_t height = mLayout.GetHeight();
+    const bool resized = mPresentPixels.size() != static_cast<size_t>(width) * height;
+    if (resized)
+    {
+        mPresentPixels.assign(static_cast<size_t>(width) * height, kEmptyPixel);
+    }
+
+    // Written pixels are shown opaque, empty ones keep zero alpha so the background shows through.
+    // Returns whether any pixel differs from what the last frame presented.
+    const __m128i empty = _mm_set1_epi32(static_cast<int>(kEmptyPixel));
+    const __m128i opaque = _mm_set1_epi32(static_cast<int>(0xff000000u));
+    auto presentRow = [&](uint32_t y, uint32_t left, uint32_t right, uint32_t& covered)
+    {
+        uint32_t* row = mPresentPixels.data() + static_cast<size_t>(y) * width;
+        __m128i difference = _mm_setzero_si128();
+        uint32_t x = left;
+        if (mLayout.GetLayout() == MemoryLayout::Linear)
+        {
+            const uint32_t* source = mPixels.data() + static_cast<size_t>(y) * width;
+            for (; x + 4 <= right; x += 4)
+            {
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x));
+                const __m128i isEmpty = _mm_cmpeq_epi32(pixels, empty);
+                const __m128i shown = _mm_andnot_si128(isEmpty, _mm_or_si128(pixels, opaque));
+                __m128i* target = reinterpret_cast<__m128i*>(row + x);
+                difference = _mm_or_si128(difference, _mm_xor_si128(_mm_loadu_si128(target), shown));
+                _mm_storeu_si128(target, shown);
+                covered += 4 - kLaneCount[_mm_movemask_ps(_mm_castsi128_ps(isEmpty))];
+            }
+        }
+        bool changed = _mm_movemask_epi8(_mm_cmpeq_epi32(difference, _mm_setzero_si128())) != 0xffff;
+        for (; x < right; ++x)
+        {
+            const uint32_t pixel = mPixels[mLayout.GetIndex(x, y)];
+            const uint32_t shown = pixel != kEmptyPixel ? pixel | 0xff000000u : kEmptyPixel;
+            changed |= row[x] != shown;
+            row[x] = shown;
+            covered += pixel != kEmptyPixel ? 1 : 0;
+        }
+        return changed;
+    };
+
+    // Tiles kept from the last frame are as they were presented, the rest are compared while converting.
+    // Only those count as covered, kept tiles were not written to, so the ratio to the writes stays the overdraw.
+    // Changed tiles next to each other on a tile row go up as one area.
+    uint32_t pixelsCovered = 0;
+    mTilesUploaded = 0;
+    mDirtyRects.clear();
+    for (uint32_t tileY = 0; tileY < mTileRows; ++tileY)
+    {
+        const uint32_t top = tileY << kTileShift;
+        const uint32_t bottom = std::min(top + kTileSize, height);
+        for (uint32_t tileX = 0; tileX < mTileColumns; ++tileX)
+        {
+            const uint32_t tile = tileY * mTileColumns + tileX;
+            if (!resized && mTileKept[tile] == kKeptFromLastFrame)
+            {
+                continue;
+            }
+
+            const uint32_t left = tileX << kTileShift;
+            const uint32_t right = std::min(left + kTileSize, width);
+            uint32_t covered = 0;
+            bool changed = resized;
+            for (uint32_t y = top; y < bottom; ++y)
+            {
+                changed |= presentRow(y, left, right, covered);
+            }
+            pixelsCovered += covered;
+            if (!changed)
+            {
+                continue;
+            }
+
+            ++mTilesUploaded;
+            if (!mDirtyRects.empty() && mDirtyRects.back().top == top && mDirtyRects.back().right == left)
+            {
+                mDirtyRects.back().right = right;
+            }
+            else
+            {
+                mDirtyRects.push_back({ left, top, right, bottom });
+            }
+        }
+    }
+    return pixelsCovered;
+}
+
+// Every combination the rasterizer span kernels use
+template void FrameBuffer::WritePixels<BlendMode::Opaque, false>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Opaque, true>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Alpha, false>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Alpha, true>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Additive, false>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Additive, true>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Multiply, false>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Multiply, true>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Premultiplied, false>(int, int, int, __m128i, __m128);
+template void FrameBuffer::WritePixels<BlendMode::Premultiplied, true>(int, int, int, __m128i, __m128);
+template void FrameBuffer::FillSpan<BlendMode::Opaque>(int, int, int, uint32_t);
+template void FrameBuffer::FillSpan<BlendMode::Alpha>(int, int, int, uint32_t);
+template void FrameBuffer::FillSpan<BlendMode::Additive>(int, int, int, uint32_t);
+template void FrameBuffer::FillSpan<BlendMode::Multiply>(int, int, int, uint32_t);
+template void FrameBuffer::FillSpan<BlendMode::Premultiplied>(int, int, int, uint32_t);
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "SurfaceLayout.h"
+
+#include <XEngine.h>
+#include <chrono>
+#include <vector>
+
+// How a new pixel is combined with the one already in the frame buffer
+enum class BlendMode
+{
+    // Overwrite
+    Opaque,
+    // src * a + dst * (1 - a)
+    Alpha,
+    // dst + src * a
+    Additive,
+    // dst * lerp(1, src, a)
+    Multiply,
+    // Color already multiplied by alpha, src + dst * (1 - a)
+    Premultiplied,
+};
+
+// CPU side render target the rasterizer writes to.
+// Pixels are packed RGBA8 in the chosen memory layout, Present converts them for the render texture.
+// A float depth buffer in the same layout backs the depth test.
+// With multisampling a pixel keeps one color until an edge covers part of it, only then does it get samples of its own.
+// Draws hash their inputs into the square tiles they touch. A tile whose draws were the same over the last two frames
+// is kept from the last frame, it is not cleared and writes to it are dropped, so draws that only touch kept tiles
+// need not be rasterized at all. With a frame budget, the tiles that are due are drawn a share per pass, and what
+// does not fit in the budget shows the last frame until a later frame gets to it.
+class FrameBuffer
+{
+public:
+    static FrameBuffer* Get();
+
+    static constexpr uint32_t kMaxSampleCount = 8;
+    static constexpr int kTileShift = 5;
+    static constexpr int kTileSize = 1 << kTileShift;
+    // Position of a sample in 1/16 pixel steps from the point the pixel samples without multisampling
+    struct SampleOffset
+    {
+        int x, y;
+    };
+
+public:
+    // Resize to the render resolution, contents are only reset when the size changes
+    void Initialize(uint32_t width, uint32_t height);
+    // Reorder the pixels into a new layout
+    void SetLayout(MemoryLayout layout);
+    MemoryLayout GetLayout() const { return mLayout.GetLayout(); }
+    uint32_t GetWidth() const { return mLayout.GetWidth(); }
+    uint32_t GetHeight() const { return mLayout.GetHeight(); }
+
+    // Start a pass of the script: mark every pixel outside kept tiles as not drawn, reset their depth to the far end
+    // and go back to one sample per pixel
+    void Clear();
+
+    // Hash of draw inputs, chain calls through hash to cover several pieces
+    static uint64_t HashInput(const void* data, size_t size, uint64_t hash = kInputHashSeed);
+    // Add a draw reaching pixels minX to maxX and minY to maxY to the tiles it touches.
+    // Returns false when all of them are kept and the draw can be skipped.
+    bool AddTileInput(int minX, int minY, int maxX, int maxY, uint64_t hash);
+    // Whether every tile the area touches is kept, so nothing drawn there would show
+    bool IsAreaKept(int minX, int minY, int maxX, int maxY) const;
+    // For draws that reach beyond their own tiles, like a flood fill. Nothing is kept on the next frame.
+    void InvalidateTiles();
+    // Milliseconds this frame may spend on passes, 0 for no limit. Reset every frame.
+    void SetFrameBudget(float milliseconds);
+    // End of a pass of the script. Returns false when tiles are still due, kept ones that got different draws after all
+    // or ones the last pass left for lack of time, and the budget allows another pass. The script then has to run
+    // again, from Clear, to draw the next of them.
+    bool FinishPass();
+    // Whether the current pass draws tiles an earlier pass of the same frame left
+    bool IsContinuingFrame() const { return mContinuingFrame; }
+    uint32_t GetTileCount() const { return static_cast<uint32_t>(mTileKept.size()); }
+    // Tiles drawn this frame rather than kept, tiles Present found changed and uploaded, and tiles left for later frames
+    uint32_t GetTilesDrawn() const { return mTilesDrawn; }
+    uint32_t GetTilesUploaded() const { return mTilesUploaded; }
+    uint32_t GetTilesPending() const { return mStaleTileCount; }
+
+    // Samples per pixel for the rest of the frame, 4 or 8, anything else turns multisampling off
+    void SetSampleCount(uint32_t count);
+    uint32_t GetSampleCount() const { return mSampleCount; }
+    // Sample pattern of the current sample count, GetSampleCount() entries
+    const SampleOffset* GetSampleOffsets() const;
+    // Coverage of the pixels from startX along the row being drawn, bit i for sample i.
+    // Coverage is read 4 pixels at a time, so 3 bytes past the last pixel must be readable.
+    // While set, multisampled writes only touch the covered samples. nullptr goes back to full coverage.
+    void SetSampleCoverage(const uint8_t* coverage, int startX);
+    // Average the samples of every pixel that holds them apart into its color
+    void Resolve();
+
+    // Pixels outside the buffer are ignored
+    void SetPixel(int x, int y, const X::Color& color, BlendMode mode = BlendMode::Opaque);
+    // Up to 4 packed pixels from (x, y) along the row, one per SIMD lane, lanes picked by the bits of mask.
+    // With DepthTest a lane is only written when its depth is less than the stored one, which it replaces.
+    template <BlendMode Mode, bool DepthTest>
+    void WritePixels(int x, int y, int mask, __m128i pixels, __m128 depth);
+    // Pixels startX to endX of row y set to one color
+    template <BlendMode Mode>
+    void FillSpan(int y, int startX, int endX, uint32_t pixel);
+    // Same with the blend mode picked at run time
+    void FillSpan(int y, int startX, int endX, const X::Color& color, BlendMode mode);
+    // Pixels startX to endX of row y overwritten from a row of packed colors, clipping is left to the caller
+    void WriteSpan(int y, int startX, int endX, const uint32_t* pixels);
+
+    // Fill the 4-connected region around (x, y) whose pixels are within tolerance of the seed pixel in every channel,
+    // tolerance being 0-1 of a channel's range. Returns how many pixels the region has.
+    uint32_t FloodFill(int x, int y, const X::Color& color, float tolerance, BlendMode mode);
+
+    // Pack 4 float colors, one per SIMD lane, into RGBA8
+    static __m128i PackColors(__m128 r, __m128 g, __m128 b, __m128 a);
+
+    // Convert back to 2D order at the render resolution and note the runs of tiles that changed since the last frame,
+    // so only those need uploading. Magnifying to the pixel size is left to presentation.
+    // Returns how many pixels the tiles drawn this frame cover.
+    uint32_t Present();
+    // The frame Present converted, row after row, and the areas of it that changed
+    const std::vector<uint32_t>& GetPresentPixels() const { return mPresentPixels; }
+    const std::vector<X::PixelRect>& GetChangedRects() const { return mDirtyRects; }
+
+    // Pixel writes since the last Clear, more than the pixels presented means overdraw
+    uint32_t GetPixelsWritten() const { return mPixelsWritten; }
+
+private:
+    static constexpr uint64_t kInputHashSeed = 0xcbf29ce484222325ull;
+
+    // FillSpan after clipping, for a run that has no kept tiles
+    template <BlendMode Mode>
+    void FillRun(int y, int startX, int endX, uint32_t pixel);
+    // Lanes of a group of 4 pixels of row y from x that are outside kept tiles
+    int GetWritableLanes(int x, int y) const;
+    // Narrow startX to endX of row y to its first run outside kept tiles, false when there is none
+    bool NextWritableRun(int y, int& startX, int& endX) const;
+    // Back to nothing kept and no history, for a new size
+    void ResetTiles();
+    // Make the stale tiles that fit the budget, or all tiles, writable for the next pass and keep the rest
+    void SelectPassTiles(bool drawAll);
+    // Clear the pixels and depth of one tile
+    void ClearTile(uint32_t tile, bool clearDepth);
+
+    // Lanes of a WritePixels call that need their samples written one by one are written here and dropped from the mask
+    template <BlendMode Mode, bool DepthTest>
+    int WriteSampleLanes(int x, int y, int mask, __m128i pixels, __m128 depth);
+    // One pixel's covered samples, a single color pixel first takes a block of samples holding its color
+    template <BlendMode Mode, bool DepthTest, uint32_t SampleCount>
+    void WriteSamples(uint32_t index, uint32_t coverage, uint32_t pixel, float depth);
+    // Every pixel back to a single color and the sample pool emptied
+    void ResetSamples();
+
+    std::vector<uint32_t> mPixels;
+    std::vector<float> mDepth;
+    // Row after row copy of the frame, as Present last converted it
+    std::vector<uint32_t> mPresentPixels;
+    SurfaceLayout mLayout;
+    uint32_t mPixelsWritten = 0;
+    // Depth is only cleared after a frame that tested against it
+    bool mDepthWritten = false;
+
+    // Per pixel, whether it is a single color or has samples of its own, and then the index of its block in the sample pool.
+    // Blocks are handed out in order through the frame, so the few pixels on edges share a small stretch of memory,
+    // and each remembers its pixel so resolving and emptying the pool only visit those.
+    // The pool is kept while multisampling is off so turning it on every frame does not reallocate.
+    std::vector<uint8_t> mSampleState;
+    std::vector<uint32_t> mSampleBlocks;
+    std::vector<uint32_t> mSampleBlockPixels;
+    std::vector<uint32_t> mSamples;
+    std::vector<float> mSampleDepth;
+    uint32_t mSampleBlockCount = 0;
+    const uint8_t* mSampleCoverage = nullptr;
+    int mSampleCoverageX = 0;
+    uint32_t mSampleCount = 1;
+
+    // Per tile, row after row: the hash of this frame's draws so far, the last frame's, the draws its pixels were drawn
+    // with, whether its draws changed over the last two frames as two bits, whether it is kept this pass,
+    // and whether its pixels are behind its draws
+    std::vector<uint64_t> mTileHashes;
+    std::vector<uint64_t> mLastTileHashes;
+    std::vector<uint64_t> mDrawnTileHashes;
+    std::vector<uint8_t> mTileChanges;
+    std::vector<uint8_t> mTileKept;
+    std::vector<uint8_t> mTileStale;
+    uint32_t mTileColumns = 0;
+    uint32_t mTileRows = 0;
+    uint32_t mKeptTileCount = 0;
+    uint32_t mStaleTileCount = 0;
+    uint32_t mTilesDrawn = 0;
+    uint32_t mTilesUploaded = 0;
+    bool mTilesInvalidated = false;
+    // The current pass draws tiles an earlier pass of the same frame left, what that drew stays
+    bool mContinuingFrame = false;
+
+    // Tiles the current pass draws, the milliseconds a tile is expected to take, and where the next pass looks first
+    uint32_t mPassTileCount = 0;
+    float mTileTime = 0.0f;
+    uint32_t mNextTile = 0;
+    float mFrameBudget = 0.0f;
+    std::chrono::steady_clock::time_point mFrameStart;
+    std::chrono::steady_clock::time_point mPassStart;
+    // Runs of tiles Present found changed
+    std::vector<X::PixelRect> mDirtyRects;
+};
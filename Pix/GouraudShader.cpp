@@ -0,0 +1,12 @@
+#include "GouraudShader.h"
+
+#include <cstring>
+
+void GouraudShader::ShadePixels(PixelBatch& batch) const
+{
+    const size_t size = ((batch.count + 3) & ~3) * sizeof(float);
+    for (int channel = 0; channel < 4; ++channel)
+    {
+        std::memcpy(batch.color[channel], batch.varyings[PixelBatch::R + channel], size);
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Shader.h"
+
+// Interpolated vertex colors, the same image as the fixed pipeline
+class GouraudShader : public Shader
+{
+public:
+    const char* GetName() const override
+    {
+        return "gouraud";
+    }
+
+    void ShadePixels(PixelBatch& batch) const override;
+};
@@ -1,8 +1,39 @@
 #include "Graphics.h"
 
+#include "FrameBuffer.h"
+#include "InstanceManager.h"
+#include "MeshManager.h"
+#include "PathManager.h"
+#include "PrimitivesManager.h"
+#include "Rasterizer.h"
+#include "RenderStats.h"
+#include "TransformState.h"
 #include "Viewport.h"
 
 void Graphics::NewFrame()
 {
 	Viewport::Get()->OnNewFrame();
-}
\ No newline at end of file
+	RenderStats::Get()->OnNewFrame();
+	InstanceManager::Get()->OnNewFrame();
+	MeshManager::Get()->OnNewFrame();
+	PrimitivesManager::Get()->OnNewFrame();
+	PathManager::Get()->OnNewFrame();
+	Rasterizer::Get()->OnNewFrame();
+	TransformState::Get()->OnNewFrame();
+	FrameBuffer::Get()->Clear();
+}
+
+bool Graphics::EndFrame()
+{
+	FrameBuffer* frameBuffer = FrameBuffer::Get();
+	if (!frameBuffer->FinishPass())
+	{
+		return false;
+	}
+	frameBuffer->Resolve();
+	const uint32_t pixelsCovered = frameBuffer->Present();
+	RenderStats* renderStats = RenderStats::Get();
+	renderStats->SetPixelStats(frameBuffer->GetPixelsWritten(), pixelsCovered);
+	renderStats->SetTileStats(frameBuffer->GetTilesDrawn(), frameBuffer->GetTilesUploaded(), frameBuffer->GetTilesPending(), frameBuffer->GetTileCount());
+	return true;
+}
@@ -3,4 +3,7 @@
 namespace Graphics
 {
 	void NewFrame();
+	// Convert the frame buffer for presenting, after the script has run.
+	// False when tiles are still due and the frame budget allows another pass, run the script again between NewFrame and EndFrame.
+	bool EndFrame();
 }
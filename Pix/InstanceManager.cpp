@@ -0,0 +1,120 @@
+#include "InstanceManager.h"
+
+#include <XEngine.h>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t kFloatsPerRecord = 9;
+}
+
+InstanceManager* InstanceManager::Get()
+{
+    static InstanceManager sInstance;
+    return &sInstance;
+}
+
+void InstanceManager::OnNewFrame()
+{
+    mScriptInstances.Clear();
+}
+
+void InstanceManager::Clear()
+{
+    mFileInstances.clear();
+}
+
+void InstanceManager::AddInstance(const Instance& instance)
+{
+    mScriptInstances.Add(instance);
+}
+
+const InstanceStream& InstanceManager::MakeGrid(uint32_t count, float spacing)
+{
+    const uint32_t columns = static_cast<uint32_t>(ceilf(sqrtf(static_cast<float>(count))));
+    const uint32_t rows = columns > 0 ? (count + columns - 1) / columns : 0;
+    const float startX = -0.5f * spacing * static_cast<float>(columns > 0 ? columns - 1 : 0);
+    const float startY = -0.5f * spacing * static_cast<float>(rows > 0 ? rows - 1 : 0);
+
+    mGeneratedInstances.Resize(count);
+    Instance instance;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        instance.offset.x = startX + spacing * static_cast<float>(i % columns);
+        instance.offset.y = startY + spacing * static_cast<float>(i / columns);
+        mGeneratedInstances.Set(i, instance);
+    }
+    return mGeneratedInstances;
+}
+
+const InstanceStream& InstanceManager::MakeRandom(uint32_t count, float range, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> offset(-range, range);
+    std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+    std::uniform_real_distribution<float> rotation(0.0f, 360.0f);
+    std::uniform_real_distribution<float> tint(0.0f, 1.0f);
+
+    mGeneratedInstances.Resize(count);
+    Instance instance;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        instance.offset.x = offset(rng);
+        instance.offset.y = offset(rng);
+        instance.scale = scale(rng);
+        instance.rotation = rotation(rng);
+        instance.tint.r = tint(rng);
+        instance.tint.g = tint(rng);
+        instance.tint.b = tint(rng);
+        mGeneratedInstances.Set(i, instance);
+    }
+    return mGeneratedInstances;
+}
+
+const InstanceStream* InstanceManager::LoadFile(const std::string& fileName)
+{
+    auto iter = mFileInstances.find(fileName);
+    if (iter != mFileInstances.end())
+    {
+        return &iter->second;
+    }
+
+    // File names are relative to the instance folder, like texture names are to the image folder
+    const std::string root = X::ConfigGetString("PixInstancePath", "Instances");
+    std::ifstream file(root + "/" + fileName, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        return nullptr;
+    }
+
+    const std::streamoff bytes = file.tellg();
+    if (bytes < 0)
+    {
+        return nullptr;
+    }
+    file.seekg(0);
+    std::vector<float> records(static_cast<size_t>(bytes) / sizeof(float));
+    if (!file.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(float)))
+    {
+        return nullptr;
+    }
+
+    // Only whole records are used, a partial one at the end is ignored
+    const uint32_t count = static_cast<uint32_t>(records.size() / kFloatsPerRecord);
+    InstanceStream& stream = mFileInstances[fileName];
+    stream.Resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const float* r = records.data() + i * kFloatsPerRecord;
+        Instance instance;
+        instance.offset = { r[0], r[1], r[2] };
+        instance.scale = r[3];
+        instance.rotation = r[4];
+        instance.tint = { r[5], r[6], r[7], r[8] };
+        stream.Set(i, instance);
+    }
+    return &stream;
+}
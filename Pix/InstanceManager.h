@@ -0,0 +1,38 @@
+#pragma once
+
+#include "InstanceStream.h"
+
+#include <map>
+#include <string>
+
+// Sources of per instance attributes for DrawInstanced
+class InstanceManager
+{
+public:
+    static InstanceManager* Get();
+
+public:
+    // Drop the instances added by the script last frame
+    void OnNewFrame();
+    // Drop cached instance files, they are loaded again on the next script run
+    void Clear();
+
+    // Instances listed in the script with Instance()
+    void AddInstance(const Instance& instance);
+    const InstanceStream& GetScriptInstances() const { return mScriptInstances; }
+
+    // count instances on a square grid centered on the origin
+    const InstanceStream& MakeGrid(uint32_t count, float spacing);
+    // count instances with random offset in [-range, range], rotation, scale and tint.
+    // The same seed gives the same instances every frame.
+    const InstanceStream& MakeRandom(uint32_t count, float range, uint32_t seed);
+
+    // Instances from a binary file of packed float records:
+    // offset x, y, z, scale, rotation, tint r, g, b, a
+    const InstanceStream* LoadFile(const std::string& fileName);
+
+private:
+    InstanceStream mScriptInstances;
+    InstanceStream mGeneratedInstances;
+    std::map<std::string, InstanceStream> mFileInstances;
+};
@@ -0,0 +1,24 @@
+#include "InstanceStream.h"
+
+#include <XMath.h>
+#include <cmath>
+
+void InstanceStream::Add(const Instance& instance)
+{
+    Set(mChannels.Append(), instance);
+}
+
+void InstanceStream::Set(uint32_t index, const Instance& instance)
+{
+    const float radians = instance.rotation * X::Math::kDegToRad;
+    Data(Attribute::OffsetX)[index] = instance.offset.x;
+    Data(Attribute::OffsetY)[index] = instance.offset.y;
+    Data(Attribute::OffsetZ)[index] = instance.offset.z;
+    Data(Attribute::Scale)[index] = instance.scale;
+    Data(Attribute::RotCos)[index] = cosf(radians) * instance.scale;
+    Data(Attribute::RotSin)[index] = sinf(radians) * instance.scale;
+    Data(Attribute::TintR)[index] = instance.tint.r;
+    Data(Attribute::TintG)[index] = instance.tint.g;
+    Data(Attribute::TintB)[index] = instance.tint.b;
+    Data(Attribute::TintA)[index] = instance.tint.a;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "ChannelStorage.h"
+#include "MathHelper.h"
+
+#include <XColors.h>
+#include <cstdint>
+
+// Per instance attributes used by DrawInstanced
+struct Instance
+{
+    Vector3 offset;
+    float scale = 1.0f;
+    // Rotation around z in degrees
+    float rotation = 0.0f;
+    X::Color tint = X::Colors::White;
+};
+
+// Structure of arrays instance storage, laid out like VertexStream.
+// Rotation is kept as scaled cos/sin so the per vertex work is multiply-add only.
+class InstanceStream
+{
+public:
+    enum class Attribute
+    {
+        OffsetX,
+        OffsetY,
+        OffsetZ,
+        Scale,
+        RotCos,
+        RotSin,
+        TintR,
+        TintG,
+        TintB,
+        TintA,
+        Count
+    };
+
+    static constexpr uint32_t kLaneWidth = ChannelStorage<static_cast<uint32_t>(Attribute::Count)>::kLaneWidth;
+
+public:
+    void Clear() { mChannels.Clear(); }
+    // Resize the stream, growing the storage while keeping existing instances
+    void Resize(uint32_t size) { mChannels.Resize(size); }
+
+    void Add(const Instance& instance);
+    void Set(uint32_t index, const Instance& instance);
+
+    uint32_t Size() const { return mChannels.Size(); }
+    // Size rounded up to a whole number of SIMD lanes
+    uint32_t PaddedSize() const { return mChannels.PaddedSize(); }
+
+    float* Data(Attribute attribute) { return mChannels.Data(static_cast<uint32_t>(attribute)); }
+    const float* Data(Attribute attribute) const { return mChannels.Data(static_cast<uint32_t>(attribute)); }
+
+private:
+    ChannelStorage<static_cast<uint32_t>(Attribute::Count)> mChannels;
+};
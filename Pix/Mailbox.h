@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one thread to another without locks. One thread writes, one thread reads.
+// Three slots: the writer fills its own and swaps it into the middle, the reader swaps the middle out for its own
+// when it holds something newer. Values the reader never got to are skipped, neither side ever waits.
+template <class T>
+class Mailbox
+{
+public:
+    // Writer side, the slot holds an older value, so fill it in full before publishing
+    T& GetWriteSlot() { return mSlots[mWriteSlot]; }
+    void Publish()
+    {
+        mWriteSlot = mMiddle.exchange(mWriteSlot | kFresh, std::memory_order_acq_rel) & kSlotMask;
+    }
+
+    // Reader side, true when a value was published since the last receive, GetReadSlot then holds it
+    bool Receive()
+    {
+        if ((mMiddle.load(std::memory_order_relaxed) & kFresh) == 0)
+        {
+            return false;
+        }
+        mReadSlot = mMiddle.exchange(mReadSlot, std::memory_order_acq_rel) & kSlotMask;
+        return true;
+    }
+    const T& GetReadSlot() const { return mSlots[mReadSlot]; }
+
+    // Only while neither side is using the mailbox
+    void Reset()
+    {
+        for (T& slot : mSlots)
+        {
+            slot = {};
+        }
+        mWriteSlot = 0;
+        mMiddle.store(1, std::memory_order_relaxed);
+        mReadSlot = 2;
+    }
+
+private:
+    static constexpr uint32_t kSlotMask = 3;
+    static constexpr uint32_t kFresh = 4;
+
+    T mSlots[3] = {};
+    uint32_t mWriteSlot = 0;
+    std::atomic<uint32_t> mMiddle = 1;
+    uint32_t mReadSlot = 2;
+};
@@ -0,0 +1,140 @@
+#include "MeshManager.h"
+
+#include <XEngine.h>
+#include <algorithm>
+
+namespace
+{
+    // Stages cached per mesh, the least recently drawn one is replaced
+    constexpr size_t kMaxStageCaches = 4;
+}
+
+MeshManager* MeshManager::Get()
+{
+    static MeshManager sInstance;
+    return &sInstance;
+}
+
+void MeshManager::Clear()
+{
+    mMeshes.clear();
+    mRecording = nullptr;
+    mSkipping = false;
+}
+
+void MeshManager::OnNewFrame()
+{
+    if (IsRecording())
+    {
+        auto iter = std::find_if(mMeshes.begin(), mMeshes.end(), [this](const auto& entry) { return &entry.second == mRecording; });
+        XLOG("[Mesh] %s: missing EndMesh, the mesh is dropped", iter->first.c_str());
+        mMeshes.erase(iter);
+        mRecording = nullptr;
+    }
+    mSkipping = false;
+}
+
+bool MeshManager::BeginMesh(const std::string& name)
+{
+    if (IsRecording() || IsSkipping())
+    {
+        return false;
+    }
+
+    // Meshes are immutable once recorded, later runs of the block are skipped
+    auto [iter, inserted] = mMeshes.try_emplace(name);
+    if (inserted)
+    {
+        mRecording = &iter->second;
+    }
+    else
+    {
+        mSkipping = true;
+    }
+    return true;
+}
+
+bool MeshManager::EndMesh()
+{
+    if (!IsRecording() && !IsSkipping())
+    {
+        return false;
+    }
+
+    mRecording = nullptr;
+    mSkipping = false;
+    return true;
+}
+
+bool MeshManager::AddBatch(PrimitiveBatch&& batch)
+{
+    if (!IsRecording())
+    {
+        return false;
+    }
+
+    Mesh::Part& part = mRecording->parts.emplace_back();
+    part.batch = std::move(batch);
+    mRecording->caches.clear();
+    return true;
+}
+
+bool MeshManager::DrawMesh(const std::string& name)
+{
+    Mesh* mesh = FindMesh(name);
+    if (mesh == nullptr || mesh == mRecording)
+    {
+        return false;
+    }
+
+    // Reuse the processed vertices and triangle setups of a draw under the same vertex stage
+    const VertexStage stage = PrimitivesManager::GetVertexStage();
+    auto cache = std::find_if(mesh->caches.begin(), mesh->caches.end(),
+        [&stage](const Mesh::StageCache& c) { return c.stage == stage; });
+    const bool processVertices = cache == mesh->caches.end();
+    if (processVertices)
+    {
+        if (mesh->caches.size() < kMaxStageCaches)
+        {
+            cache = mesh->caches.emplace(mesh->caches.end());
+        }
+        else
+        {
+            cache = std::min_element(mesh->caches.begin(), mesh->caches.end(),
+                [](const Mesh::StageCache& a, const Mesh::StageCache& b) { return a.lastDraw < b.lastDraw; });
+        }
+        cache->stage = stage;
+        cache->processed.resize(mesh->parts.size());
+        cache->prepared.resize(mesh->parts.size());
+    }
+    cache->lastDraw = ++mesh->drawCount;
+
+    PrimitivesManager* pm = PrimitivesManager::Get();
+    for (size_t i = 0; i < mesh->parts.size(); ++i)
+    {
+        pm->DrawBatch(mesh->parts[i].batch, cache->processed[i], processVertices, &cache->prepared[i]);
+    }
+    return true;
+}
+
+bool MeshManager::DrawMeshInstanced(const std::string& name, const InstanceStream& instances, uint32_t count)
+{
+    Mesh* mesh = FindMesh(name);
+    if (mesh == nullptr || mesh == mRecording)
+    {
+        return false;
+    }
+
+    PrimitivesManager* pm = PrimitivesManager::Get();
+    for (Mesh::Part& part : mesh->parts)
+    {
+        pm->DrawBatchInstanced(part.batch, instances, count);
+    }
+    return true;
+}
+
+Mesh* MeshManager::FindMesh(const std::string& name)
+{
+    auto iter = mMeshes.find(name);
+    return iter != mMeshes.end() ? &iter->second : nullptr;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "PrimitivesManager.h"
+
+#include <map>
+#include <string>
+
+// Geometry recorded once between BeginMesh and EndMesh, replayed with DrawMesh
+struct Mesh
+{
+    struct Part
+    {
+        PrimitiveBatch batch;
+    };
+
+    // Post transform vertices of every part under one vertex stage, and the triangles set up from them
+    struct StageCache
+    {
+        VertexStage stage;
+        std::vector<VertexStream> processed;
+        std::vector<PreparedBatch> prepared;
+        uint32_t lastDraw = 0;
+    };
+
+    std::vector<Part> parts;
+    // The last few stages the mesh was drawn with, so a mesh drawn under several transforms keeps each result
+    std::vector<StageCache> caches;
+    uint32_t drawCount = 0;
+};
+
+class MeshManager
+{
+public:
+    static MeshManager* Get();
+
+public:
+    // Remove all meshes, they are recorded again on the next script run
+    void Clear();
+    // End a recording or skip the script left open. A mesh that never reached EndMesh is dropped,
+    // so the next frame records it again instead of adding to it.
+    void OnNewFrame();
+
+    // Start recording draws into a mesh, or skip them if the mesh already exists
+    bool BeginMesh(const std::string& name);
+    bool EndMesh();
+
+    // Keep a finished BeginDraw/EndDraw batch in the mesh being recorded
+    bool AddBatch(PrimitiveBatch&& batch);
+
+    // Draw a mesh with the current transform state
+    bool DrawMesh(const std::string& name);
+    // Draw count copies of a mesh, each transformed and tinted by its instance
+    bool DrawMeshInstanced(const std::string& name, const InstanceStream& instances, uint32_t count);
+
+    Mesh* FindMesh(const std::string& name);
+
+    bool IsRecording() const { return mRecording != nullptr; }
+    bool IsSkipping() const { return mSkipping; }
+
+private:
+    std::map<std::string, Mesh> mMeshes;
+    Mesh* mRecording = nullptr;
+    bool mSkipping = false;
+};
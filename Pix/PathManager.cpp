@@ -0,0 +1,95 @@
+#include "PathManager.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Largest distance in pixels between a curve and its flattened lines, small enough that coverage hides it
+    constexpr float kTolerance = 0.1f;
+    // Keeps degenerate or huge curves from allocating without bound
+    constexpr uint32_t kMaxSegments = 1024;
+
+    float Length(const Vector2& v)
+    {
+        return std::sqrt(v.x * v.x + v.y * v.y);
+    }
+}
+
+PathManager* PathManager::Get()
+{
+    static PathManager sInstance;
+    return &sInstance;
+}
+
+void PathManager::OnNewFrame()
+{
+    mPoints.clear();
+    mContourEnds.clear();
+    mCurrent = Vector2();
+}
+
+void PathManager::MoveTo(const Vector2& point)
+{
+    const uint32_t pointCount = static_cast<uint32_t>(mPoints.size());
+    if (pointCount > 0 && (mContourEnds.empty() || mContourEnds.back() != pointCount))
+    {
+        mContourEnds.push_back(pointCount);
+    }
+    mPoints.push_back(point);
+    mCurrent = point;
+}
+
+void PathManager::LineTo(const Vector2& point)
+{
+    // Drawing without a MoveTo starts from the last point, or the origin
+    if (mPoints.empty())
+    {
+        mPoints.push_back(mCurrent);
+    }
+    mPoints.push_back(point);
+    mCurrent = point;
+}
+
+void PathManager::QuadTo(const Vector2& control, const Vector2& point)
+{
+    const Vector2 start = mCurrent;
+    const Vector2 secondDifference = start - control * 2.0f + point;
+    const uint32_t segments = GetSegmentCount(Length(secondDifference), 2.0f / 8.0f);
+    for (uint32_t i = 1; i < segments; ++i)
+    {
+        const float t = static_cast<float>(i) / segments;
+        const float s = 1.0f - t;
+        LineTo(start * (s * s) + control * (2.0f * s * t) + point * (t * t));
+    }
+    LineTo(point);
+}
+
+void PathManager::CubicTo(const Vector2& control0, const Vector2& control1, const Vector2& point)
+{
+    const Vector2 start = mCurrent;
+    const float secondDifference = std::max(Length(start - control0 * 2.0f + control1), Length(control0 - control1 * 2.0f + point));
+    const uint32_t segments = GetSegmentCount(secondDifference, 6.0f / 8.0f);
+    for (uint32_t i = 1; i < segments; ++i)
+    {
+        const float t = static_cast<float>(i) / segments;
+        const float s = 1.0f - t;
+        LineTo(start * (s * s * s) + control0 * (3.0f * s * s * t) + control1 * (3.0f * s * t * t) + point * (t * t * t));
+    }
+    LineTo(point);
+}
+
+void PathManager::Fill(FillRule rule)
+{
+    mContourEnds.push_back(static_cast<uint32_t>(mPoints.size()));
+    Rasterizer::Get()->FillPath(mPoints, mContourEnds, rule);
+    mPoints.clear();
+    mContourEnds.clear();
+}
+
+uint32_t PathManager::GetSegmentCount(float secondDifference, float degreeFactor)
+{
+    // Wang's formula: n segments keep a degree d curve within d(d - 1) / 8 * M / n^2 of its chords
+    const float segments = std::ceil(std::sqrt(degreeFactor * secondDifference / kTolerance));
+    return static_cast<uint32_t>(std::clamp(segments, 1.0f, static_cast<float>(kMaxSegments)));
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Rasterizer.h"
+#include "Vector2.h"
+
+#include <vector>
+
+// Vector path built up by MoveTo, LineTo, QuadTo and CubicTo, in pixels.
+// Curves are flattened to lines as they are added, FillPath hands the contours to the rasterizer.
+class PathManager
+{
+public:
+    static PathManager* Get();
+
+public:
+    // Drop a path the last frame left unfilled
+    void OnNewFrame();
+
+    // Start a new contour at point
+    void MoveTo(const Vector2& point);
+    void LineTo(const Vector2& point);
+    void QuadTo(const Vector2& control, const Vector2& point);
+    void CubicTo(const Vector2& control0, const Vector2& control1, const Vector2& point);
+    // Fill every contour, each closed back to its start, with the current color, then start an empty path
+    void Fill(FillRule rule);
+
+private:
+    // Segments for a curve whose control polygon has the given largest second difference, from Wang's formula
+    static uint32_t GetSegmentCount(float secondDifference, float degreeFactor);
+
+    std::vector<Vector2> mPoints;
+    // One past the last point of each contour before the current one
+    std::vector<uint32_t> mContourEnds;
+    Vector2 mCurrent;
+};
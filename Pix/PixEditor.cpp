@@ -6,9 +6,12 @@
 #include "PixEditor.h"
 
 #include "CommandDictionary.h"
-#include "Graphics.h"
+#include "FrameBuffer.h"
+#include "InstanceManager.h"
+#include "MeshManager.h"
+#include "RenderWorker.h"
+#include "TextureCache.h"
 #include "VariableCache.h"
-#include "Viewport.h"
 #include <ImGui/Inc/imgui.h>
 
 namespace
@@ -68,6 +71,7 @@ void PixEditor::Initialize()
 
 void PixEditor::Terminate()
 {
+	RenderWorker::Get()->Stop();
 }
 
 bool PixEditor::Run(float deltaTime)
@@ -99,6 +103,7 @@ bool PixEditor::Run(float deltaTime)
 	{
 		ShowRenderView(deltaTime);
 		VariableCache::Get()->ShowEditor();
+		RenderWorker::Get()->ShowStats();
 	}
 
 	if (mShowCloseConfirmationDialog)
@@ -351,14 +356,13 @@ void PixEditor::ShowRenderView(float deltaTime)
 		timeElapsed = 0.0f;
 	}
 
+	// The editor keeps its own frame rate, the frame shown may have taken longer to render
+	RenderWorker* renderWorker = RenderWorker::Get();
 	char title[128];
-	sprintf_s(title, "Render - fps: %.3f###Render", fps);
+	sprintf_s(title, "Render - fps: %.3f, frame: %.1f ms###Render", fps, renderWorker->GetFrameTime());
 	ImGui::Begin(title, &mShowRenderView, ImGuiWindowFlags_AlwaysAutoResize);
 
-	Graphics::NewFrame();
-	mScriptParser.ExecuteScript();
-
-	Viewport::Get()->DrawViewport();
+	renderWorker->PresentFrame();
 
 	const float renderTextureWidth = static_cast<float>(X::GetRenderTextureWidth());
 	const float renderTextureHeight = static_cast<float>(X::GetRenderTextureHeight());
@@ -546,12 +550,20 @@ void PixEditor::Run(TextEditor* textEditor)
 			textEditor = &iter->editor;
 	}
 
+	// The render thread uses everything reset here, so it has to stop first
+	RenderWorker* renderWorker = RenderWorker::Get();
+	renderWorker->Stop();
 	if (textEditor)
 	{
 		Save();
 		VariableCache::Get()->Clear();
+		MeshManager::Get()->Clear();
+		InstanceManager::Get()->Clear();
+		FrameBuffer::Get()->SetLayout(MemoryLayout::Linear);
+		TextureCache::Get()->SetLayout(MemoryLayout::Linear);
 		mScriptParser.ParseScript(textEditor->GetText());
 	}
+	renderWorker->Start(mScriptParser);
 
 	mShowRenderView = true;
 }
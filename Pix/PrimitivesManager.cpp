@@ -1,5 +1,127 @@
 #include "PrimitivesManager.h"
+
+#include "FrameBuffer.h"
+#include "MeshManager.h"
 #include "Rasterizer.h"
+#include "RenderStats.h"
+#include "Shader.h"
+#include "TransformState.h"
+#include "Viewport.h"
+
+#include <algorithm>
+#include <cstring>
+#include <emmintrin.h>
+
+extern float gResolutionX;
+extern float gResolutionY;
+
+namespace
+{
+    // Marks a primitive restart in the index buffer
+    constexpr uint32_t kRestartIndex = 0xffffffff;
+
+    // Perspective divide and NDC to screen mapping, in place. w is replaced by 1/w for interpolation.
+    // Vertices outside the near/far range get 1/w = 0 so their primitives are dropped.
+    void ProjectToScreen(float* x, float* y, float* z, float* w, float left, float top, float width, float height, uint32_t count)
+    {
+        const __m128 halfWidth = _mm_set1_ps(width * 0.5f);
+        const __m128 halfHeight = _mm_set1_ps(height * 0.5f);
+        const __m128 centerX = _mm_set1_ps(left + width * 0.5f);
+        const __m128 centerY = _mm_set1_ps(top + height * 0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        for (uint32_t i = 0; i < count; i += VertexStream::kLaneWidth)
+        {
+            const __m128 clipW = _mm_load_ps(w + i);
+            const __m128 invW = _mm_div_ps(one, clipW);
+            const __m128 ndcX = _mm_mul_ps(_mm_load_ps(x + i), invW);
+            const __m128 ndcY = _mm_mul_ps(_mm_load_ps(y + i), invW);
+            const __m128 ndcZ = _mm_mul_ps(_mm_load_ps(z + i), invW);
+
+            // NDC y points up, screen y points down
+            _mm_store_ps(x + i, _mm_add_ps(centerX, _mm_mul_ps(ndcX, halfWidth)));
+            _mm_store_ps(y + i, _mm_sub_ps(centerY, _mm_mul_ps(ndcY, halfHeight)));
+            _mm_store_ps(z + i, ndcZ);
+
+            const __m128 outside = _mm_or_ps(_mm_cmplt_ps(ndcZ, zero), _mm_cmpgt_ps(ndcZ, one));
+            _mm_store_ps(w + i, _mm_andnot_ps(outside, invW));
+        }
+    }
+
+    // Applies every instance transform and tint to every batch vertex, 4 instances at a time.
+    // Output is vertex major: vertex i of instance n lands at i * stride + n.
+    void ExpandInstances(const VertexStream& input, const InstanceStream& instances, uint32_t stride, VertexStream& output)
+    {
+        using Attribute = VertexStream::Attribute;
+        using InstanceAttribute = InstanceStream::Attribute;
+
+        const float* offsetX = instances.Data(InstanceAttribute::OffsetX);
+        const float* offsetY = instances.Data(InstanceAttribute::OffsetY);
+        const float* offsetZ = instances.Data(InstanceAttribute::OffsetZ);
+        const float* scale = instances.Data(InstanceAttribute::Scale);
+        const float* rotCos = instances.Data(InstanceAttribute::RotCos);
+        const float* rotSin = instances.Data(InstanceAttribute::RotSin);
+        const float* tintR = instances.Data(InstanceAttribute::TintR);
+        const float* tintG = instances.Data(InstanceAttribute::TintG);
+        const float* tintB = instances.Data(InstanceAttribute::TintB);
+        const float* tintA = instances.Data(InstanceAttribute::TintA);
+
+        const __m128 one = _mm_set1_ps(1.0f);
+        const uint32_t vertexCount = input.Size();
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            const __m128 vx = _mm_set1_ps(input.Data(Attribute::PosX)[v]);
+            const __m128 vy = _mm_set1_ps(input.Data(Attribute::PosY)[v]);
+            const __m128 vz = _mm_set1_ps(input.Data(Attribute::PosZ)[v]);
+            const __m128 vr = _mm_set1_ps(input.Data(Attribute::ColorR)[v]);
+            const __m128 vg = _mm_set1_ps(input.Data(Attribute::ColorG)[v]);
+            const __m128 vb = _mm_set1_ps(input.Data(Attribute::ColorB)[v]);
+            const __m128 va = _mm_set1_ps(input.Data(Attribute::ColorA)[v]);
+            const __m128 vu = _mm_set1_ps(input.Data(Attribute::TexU)[v]);
+            const __m128 vv = _mm_set1_ps(input.Data(Attribute::TexV)[v]);
+
+            const uint32_t base = v * stride;
+            float* outX = output.Data(Attribute::PosX) + base;
+            float* outY = output.Data(Attribute::PosY) + base;
+            float* outZ = output.Data(Attribute::PosZ) + base;
+            float* outW = output.Data(Attribute::PosW) + base;
+            float* outR = output.Data(Attribute::ColorR) + base;
+            float* outG = output.Data(Attribute::ColorG) + base;
+            float* outB = output.Data(Attribute::ColorB) + base;
+            float* outA = output.Data(Attribute::ColorA) + base;
+            float* outU = output.Data(Attribute::TexU) + base;
+            float* outV = output.Data(Attribute::TexV) + base;
+
+            for (uint32_t i = 0; i < stride; i += InstanceStream::kLaneWidth)
+            {
+                // Scale and rotate around z, then offset. Cos and sin are pre-multiplied by the scale.
+                const __m128 c = _mm_load_ps(rotCos + i);
+                const __m128 s = _mm_load_ps(rotSin + i);
+                const __m128 x = _mm_sub_ps(_mm_mul_ps(vx, c), _mm_mul_ps(vy, s));
+                const __m128 y = _mm_add_ps(_mm_mul_ps(vx, s), _mm_mul_ps(vy, c));
+                _mm_store_ps(outX + i, _mm_add_ps(x, _mm_load_ps(offsetX + i)));
+                _mm_store_ps(outY + i, _mm_add_ps(y, _mm_load_ps(offsetY + i)));
+                _mm_store_ps(outZ + i, _mm_add_ps(_mm_mul_ps(vz, _mm_load_ps(scale + i)), _mm_load_ps(offsetZ + i)));
+                _mm_store_ps(outW + i, one);
+                _mm_store_ps(outR + i, _mm_mul_ps(vr, _mm_load_ps(tintR + i)));
+                _mm_store_ps(outG + i, _mm_mul_ps(vg, _mm_load_ps(tintG + i)));
+                _mm_store_ps(outB + i, _mm_mul_ps(vb, _mm_load_ps(tintB + i)));
+                _mm_store_ps(outA + i, _mm_mul_ps(va, _mm_load_ps(tintA + i)));
+                _mm_store_ps(outU + i, vu);
+                _mm_store_ps(outV + i, vv);
+            }
+        }
+    }
+}
+
+bool VertexStage::operator==(const VertexStage& rhs) const
+{
+    return
+        std::equal(&transform._11, &transform._44 + 1, &rhs.transform._11) &&
+        left == rhs.left && top == rhs.top && width == rhs.width && height == rhs.height &&
+        identity == rhs.identity && projection == rhs.projection && shader == rhs.shader;
+}
 
 PrimitivesManager::PrimitivesManager()
 {
@@ -11,10 +133,25 @@ PrimitivesManager* PrimitivesManager::Get()
     return&sInstance;
 }
 
-bool PrimitivesManager::BeginDraw(Topology topology)
+void PrimitivesManager::OnNewFrame()
 {
-    mVertexBuffer.clear();
-    mTopology = topology;
+    mFilledFrameStreams = FrameBuffer::Get()->IsContinuingFrame() ? std::max(mFilledFrameStreams, mFrameDrawCount) : 0;
+    mFrameDrawCount = 0;
+}
+
+bool PrimitivesManager::BeginDraw(Topology topology, bool indexed, FillRule fillRule)
+{
+    // Geometry of a mesh that is already recorded is not captured again
+    if (MeshManager::Get()->IsSkipping())
+    {
+        return true;
+    }
+
+    mBatch.vertices.Clear();
+    mBatch.indices.clear();
+    mBatch.topology = topology;
+    mBatch.indexed = indexed;
+    mBatch.fillRule = fillRule;
     mDrawBegin = true;
     return true;
 }
@@ -23,7 +160,28 @@ void PrimitivesManager::AddVertex(const Vertex& vertex)
 {
     if (mDrawBegin)
     {
-        mVertexBuffer.push_back(vertex);
+        // Non indexed draws walk the vertex list in order
+        if (!mBatch.indexed)
+        {
+            mBatch.indices.push_back(mBatch.vertices.Size());
+        }
+        mBatch.vertices.Add(vertex);
+    }
+}
+
+void PrimitivesManager::AddIndex(uint32_t index)
+{
+    if (mDrawBegin && mBatch.indexed)
+    {
+        mBatch.indices.push_back(index);
+    }
+}
+
+void PrimitivesManager::RestartPrimitive()
+{
+    if (mDrawBegin)
+    {
+        mBatch.indices.push_back(kRestartIndex);
     }
 }
 
@@ -31,38 +189,326 @@ bool PrimitivesManager::EndDraw()
 {
     if (!mDrawBegin)
     {
-        return false;
+        // Nothing was recorded while skipping an existing mesh
+        return MeshManager::Get()->IsSkipping();
+    }
+    mDrawBegin = false;
+
+    // While recording a mesh, the batch is kept instead of drawn
+    MeshManager* mm = MeshManager::Get();
+    if (mm->IsRecording())
+    {
+        return mm->AddBatch(std::move(mBatch));
+    }
+
+    bool processVertices = true;
+    VertexStream& processed = NextFrameStream(mBatch.vertices.Size(), processVertices);
+    DrawBatch(mBatch, processed, processVertices);
+    return true;
+}
+
+VertexStage PrimitivesManager::GetVertexStage()
+{
+    const TransformState* ts = TransformState::Get();
+
+    VertexStage stage;
+    stage.transform = ts->GetTransform();
+    stage.identity = ts->IsIdentity();
+    stage.projection = ts->HasProjection();
+    stage.shader = Rasterizer::Get()->GetShader();
+    if (stage.projection)
+    {
+        // Map to the viewport if one is set, otherwise to the whole render target
+        const Viewport* viewport = Viewport::Get();
+        stage.width = gResolutionX;
+        stage.height = gResolutionY;
+        if (viewport->GetMaxX() > viewport->GetMinX() && viewport->GetMaxY() > viewport->GetMinY())
+        {
+            stage.left = viewport->GetMinX();
+            stage.top = viewport->GetMinY();
+            stage.width = viewport->GetMaxX() - stage.left;
+            stage.height = viewport->GetMaxY() - stage.top;
+        }
+    }
+    return stage;
+}
+
+void PrimitivesManager::DrawBatch(const PrimitiveBatch& batch, VertexStream& processed, bool processVertices, PreparedBatch* prepared)
+{
+    // Process every vertex once up front, primitives then only fetch results
+    if (processVertices)
+    {
+        ProcessVertices(batch.vertices, processed, GetVertexStage());
+    }
+
+    const uint32_t indexCount = static_cast<uint32_t>(batch.indices.size());
+    const uint32_t restartCount = static_cast<uint32_t>(std::count(batch.indices.begin(), batch.indices.end(), kRestartIndex));
+    uint32_t triangleCount = 0;
+
+    // Solid triangles of a batch drawn again with the same processed vertices skip straight to rasterizing
+    Rasterizer* rasterizer = Rasterizer::Get();
+    const bool triangleTopology = batch.topology == Topology::Triangle || batch.topology == Topology::TriangleStrip || batch.topology == Topology::TriangleFan;
+    std::vector<PreparedTriangle>* prepare = nullptr;
+    if (prepared != nullptr && triangleTopology && rasterizer->GetFillMode() == FillMode::Solid)
+    {
+        if (prepared->valid && !processVertices)
+        {
+            for (const PreparedTriangle& triangle : prepared->triangles)
+            {
+                rasterizer->DrawPreparedTriangle(triangle);
+            }
+            RenderStats::Get()->AddDraw(indexCount - restartCount, 0, static_cast<uint32_t>(prepared->triangles.size()));
+            return;
+        }
+        prepared->triangles.clear();
+        prepared->valid = true;
+        prepare = &prepared->triangles;
+    }
+
+    // Split the index list at restart markers and draw each run
+    if (batch.topology == Topology::Polygon)
+    {
+        triangleCount = DrawPrimitives(batch, processed, batch.indices.data(), indexCount);
+    }
+    else
+    {
+        uint32_t runStart = 0;
+        for (uint32_t i = 0; i <= indexCount; ++i)
+        {
+            if (i == indexCount || batch.indices[i] == kRestartIndex)
+            {
+                triangleCount += DrawPrimitives(batch, processed, batch.indices.data() + runStart, i - runStart, 0, 1, prepare);
+                runStart = i + 1;
+            }
+        }
+    }
+
+    const uint32_t verticesProcessed = processVertices ? processed.Size() : 0;
+    RenderStats::Get()->AddDraw(indexCount - restartCount, verticesProcessed, triangleCount);
+}
+
+void PrimitivesManager::DrawBatchInstanced(const PrimitiveBatch& batch, const InstanceStream& instances, uint32_t count)
+{
+    count = std::min(count, instances.Size());
+    const uint32_t vertexCount = batch.vertices.Size();
+    if (count == 0 || vertexCount == 0)
+    {
+        return;
+    }
+
+    // Expand and process the drawn instances at once, the vertex stage then runs in one pass.
+    // The stride covers count rounded up to whole lanes, instances past it are never expanded.
+    const uint32_t stride = (count + InstanceStream::kLaneWidth - 1) & ~(InstanceStream::kLaneWidth - 1);
+    bool processVertices = true;
+    VertexStream& processed = NextFrameStream(vertexCount * stride, processVertices);
+    if (processVertices)
+    {
+        mInstancedStream.Resize(vertexCount * stride);
+        ExpandInstances(batch.vertices, instances, stride, mInstancedStream);
+        ProcessVertices(mInstancedStream, processed, GetVertexStage());
     }
+
+    // Split the index list at restart markers once, every instance draws the same runs
+    // Polygons are a single run, the restarts separate their contours
+    struct Run { uint32_t start, count; };
+    std::vector<Run> runs;
+    const uint32_t indexCount = static_cast<uint32_t>(batch.indices.size());
+    const uint32_t restartCount = static_cast<uint32_t>(std::count(batch.indices.begin(), batch.indices.end(), kRestartIndex));
+    uint32_t runStart = 0;
+    for (uint32_t i = 0; i <= indexCount; ++i)
+    {
+        if (i == indexCount || (batch.indices[i] == kRestartIndex && batch.topology != Topology::Polygon))
+        {
+            runs.push_back({ runStart, i - runStart });
+            runStart = i + 1;
+        }
+    }
+
+    uint32_t triangleCount = 0;
+    for (uint32_t instance = 0; instance < count; ++instance)
+    {
+        for (const Run& run : runs)
+        {
+            triangleCount += DrawPrimitives(batch, processed, batch.indices.data() + run.start, run.count, instance, stride);
+        }
+    }
+
+    const uint32_t verticesProcessed = processVertices ? vertexCount * count : 0;
+    RenderStats::Get()->AddDraw((indexCount - restartCount) * count, verticesProcessed, triangleCount);
+}
+
+VertexStream& PrimitivesManager::NextFrameStream(uint32_t inputSize, bool& processVertices)
+{
+    if (mFrameDrawCount == mFrameStreams.size())
+    {
+        mFrameStreams.emplace_back();
+    }
+    const uint32_t index = mFrameDrawCount++;
+    FrameStream& frameStream = mFrameStreams[index];
+    const VertexStage stage = GetVertexStage();
+    processVertices = index >= mFilledFrameStreams || frameStream.inputSize != inputSize || frameStream.stage != stage;
+    frameStream.stage = stage;
+    frameStream.inputSize = inputSize;
+    return frameStream.processed;
+}
+
+uint32_t PrimitivesManager::DrawPrimitives(const PrimitiveBatch& batch, const VertexStream& processed, const uint32_t* indices, uint32_t count,
+    uint32_t instance, uint32_t stride, std::vector<PreparedTriangle>* prepared)
+{
+    const Topology topology = batch.topology;
+    // Vertices behind the camera (1/w <= 0) are dropped along with their primitives
+    const uint32_t vertexCount = processed.Size() / stride;
+    const float* w = processed.Data(VertexStream::Attribute::PosW);
+    auto isValid = [vertexCount, w, instance, stride](uint32_t index) { return index < vertexCount && w[index * stride + instance] > 0.0f; };
+    auto fetch = [&processed, instance, stride](uint32_t index) { return processed.Get(index * stride + instance); };
+    uint32_t triangleCount = 0;
+
     Rasterizer* rasterizer = Rasterizer::Get();
-    switch (mTopology)
+    switch (topology)
     {
     case Topology::Point:
     {
-        for (uint32_t i = 0; i < mVertexBuffer.size(); ++i)
+        for (uint32_t i = 0; i < count; ++i)
         {
-            rasterizer->DrawPoint(mVertexBuffer[i]);
+            if (isValid(indices[i]))
+            {
+                rasterizer->DrawPoint(fetch(indices[i]));
+            }
         }
     }
     break;
     case Topology::Line:
+    case Topology::LineStrip:
+    case Topology::LineLoop:
     {
-        for (uint32_t i = 1; i < mVertexBuffer.size(); i += 2)
+        // Lists step by 2, strips and loops share the previous vertex
+        const uint32_t step = topology == Topology::Line ? 2 : 1;
+        for (uint32_t i = 1; i < count; i += step)
         {
-            rasterizer->DrawLine(mVertexBuffer[i - 1], mVertexBuffer[i]);
+            const uint32_t a = indices[i - 1];
+            const uint32_t b = indices[i];
+            if (isValid(a) && isValid(b))
+            {
+                rasterizer->DrawLine(fetch(a), fetch(b));
+            }
+        }
+
+        // Close the loop back to the first vertex
+        if (topology == Topology::LineLoop && count > 2)
+        {
+            const uint32_t a = indices[count - 1];
+            const uint32_t b = indices[0];
+            if (isValid(a) && isValid(b))
+            {
+                rasterizer->DrawLine(fetch(a), fetch(b));
+            }
         }
     }
     break;
     case Topology::Triangle:
+    case Topology::TriangleStrip:
+    case Topology::TriangleFan:
     {
-        for (uint32_t i = 2; i < mVertexBuffer.size(); i += 3)
+        const uint32_t step = topology == Topology::Triangle ? 3 : 1;
+        for (uint32_t i = 2; i < count; i += step)
         {
-            rasterizer->DrawTriangle(mVertexBuffer[i - 2], mVertexBuffer[i - 1], mVertexBuffer[i]);
+            uint32_t a = indices[i - 2];
+            uint32_t b = indices[i - 1];
+            uint32_t c = indices[i];
+            if (topology == Topology::TriangleStrip && (i % 2) == 1)
+            {
+                // Every other strip triangle is flipped to keep the winding consistent
+                std::swap(a, b);
+            }
+            else if (topology == Topology::TriangleFan)
+            {
+                // Fans pivot around the first vertex
+                a = indices[0];
+            }
+
+            if (isValid(a) && isValid(b) && isValid(c))
+            {
+                if (prepared != nullptr)
+                {
+                    prepared->emplace_back();
+                    rasterizer->PrepareTriangle(fetch(a), fetch(b), fetch(c), prepared->back());
+                    rasterizer->DrawPreparedTriangle(prepared->back());
+                }
+                else
+                {
+                    rasterizer->DrawTriangle(fetch(a), fetch(b), fetch(c));
+                }
+                ++triangleCount;
+            }
+        }
+    }
+    break;
+    case Topology::Polygon:
+    {
+        // The shape is dropped whole if any vertex is, a partial outline would fill the wrong area
+        mPolygonVertices.clear();
+        mPolygonContourEnds.clear();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (indices[i] == kRestartIndex)
+            {
+                mPolygonContourEnds.push_back(static_cast<uint32_t>(mPolygonVertices.size()));
+                continue;
+            }
+            if (!isValid(indices[i]))
+            {
+                return 0;
+            }
+            mPolygonVertices.push_back(fetch(indices[i]));
+        }
+        mPolygonContourEnds.push_back(static_cast<uint32_t>(mPolygonVertices.size()));
+        if (!mPolygonVertices.empty())
+        {
+            rasterizer->DrawPolygon(mPolygonVertices, mPolygonContourEnds, batch.fillRule);
         }
     }
     break;
     default:
-        return false;
+        break;
     }
 
-    return false;
-}
\ No newline at end of file
+    return triangleCount;
+}
+
+void PrimitivesManager::ProcessVertices(const VertexStream& input, VertexStream& output, const VertexStage& stage)
+{
+    using Attribute = VertexStream::Attribute;
+
+    output.Resize(input.Size());
+    const uint32_t count = input.PaddedSize();
+
+    if (stage.shader != nullptr)
+    {
+        // Programmable vertex function, the identity stage still goes through it
+        stage.shader->ShadeVertices(input, output, stage.identity ? X::Math::Matrix4::Identity() : stage.transform);
+    }
+    else if (stage.identity)
+    {
+        // Nothing to transform, positions are already in pixel space
+        for (Attribute attribute : { Attribute::PosX, Attribute::PosY, Attribute::PosZ, Attribute::PosW })
+        {
+            std::memcpy(output.Data(attribute), input.Data(attribute), count * sizeof(float));
+        }
+        Shader::CopyAttributes(input, output);
+    }
+    else
+    {
+        Shader::TransformPositions(input, output, stage.transform);
+        Shader::CopyAttributes(input, output);
+    }
+
+    if (stage.projection)
+    {
+        ProjectToScreen(
+            output.Data(Attribute::PosX),
+            output.Data(Attribute::PosY),
+            output.Data(Attribute::PosZ),
+            output.Data(Attribute::PosW),
+            stage.left, stage.top, stage.width, stage.height, count);
+    }
+}
@@ -1,11 +1,61 @@
 #pragma once
+#include "InstanceStream.h"
+#include "Rasterizer.h"
+#include "TriangleSetup.h"
 #include "Vertex.h"
+#include "VertexStream.h"
+
+#include <XMath.h>
+#include <vector>
+
+class Shader;
 
 enum class Topology
 {
     Point,
     Line,
+    LineStrip,
+    LineLoop,
     Triangle,
+    TriangleStrip,
+    TriangleFan,
+    // One filled shape, restarts separate its contours
+    Polygon,
+};
+
+// Vertices and indices recorded between BeginDraw and EndDraw
+struct PrimitiveBatch
+{
+    Topology topology = Topology::Point;
+    bool indexed = false;
+    // Only used by polygons
+    FillRule fillRule = FillRule::NonZero;
+    VertexStream vertices;
+    std::vector<uint32_t> indices;
+};
+
+// Filled triangles of a processed batch, prepared once and drawn again while its processed vertices stay the same
+struct PreparedBatch
+{
+    std::vector<PreparedTriangle> triangles;
+    bool valid = false;
+};
+
+// Everything the vertex stage output depends on, besides the input vertices
+struct VertexStage
+{
+    X::Math::Matrix4 transform;
+    float left = 0.0f;
+    float top = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    bool identity = true;
+    bool projection = false;
+    // Replaces the fixed transform and attribute copy when set
+    const Shader* shader = nullptr;
+
+    bool operator==(const VertexStage& rhs) const;
+    bool operator!=(const VertexStage& rhs) const { return !(*this == rhs); }
 };
 
 class PrimitivesManager
@@ -13,17 +63,67 @@ class PrimitivesManager
 public:
     static PrimitivesManager* Get();
 
-    // Start accepting vertices
-    bool BeginDraw(Topology topology);
+    // Start the draws of a pass. A pass that repairs tiles of the frame an earlier pass drew reuses that pass's
+    // post transform vertices.
+    void OnNewFrame();
+
+    // Start accepting vertices, and indices if indexed is set
+    bool BeginDraw(Topology topology, bool indexed = false, FillRule fillRule = FillRule::NonZero);
     // Add vertices to the list, onlly if drawing is enaabled
     void AddVertex(const Vertex& vertex);
+    // Add an index into the vertex list, only if drawing indexed
+    void AddIndex(uint32_t index);
+    // End the current strip/fan/loop, the next vertex starts a new one
+    void RestartPrimitive();
     // Send all the stored vertices to the rasterizer as specified topology
     bool EndDraw();
 
+    // Current vertex stage state, from the transform state and viewport
+    static VertexStage GetVertexStage();
+    // Draw a batch, processed holds its post transform vertices.
+    // If processVertices is false, processed is reused from an earlier draw with the same stage.
+    // With prepared, solid triangles are set up once for processed and only rasterized on later draws.
+    void DrawBatch(const PrimitiveBatch& batch, VertexStream& processed, bool processVertices, PreparedBatch* prepared = nullptr);
+    // Draw the first count instances of a batch, each with its own offset, scale, rotation and tint
+    void DrawBatchInstanced(const PrimitiveBatch& batch, const InstanceStream& instances, uint32_t count);
+
 private:
     PrimitivesManager();
 
-    std::vector<Vertex> mVertexBuffer;
-    Topology mTopology = Topology::Point;
+    // Send the primitives of one restart-free run of indices to the rasterizer, polygons get their whole index list.
+    // Instanced streams store vertex i of instance n at i * stride + n.
+    // Triangles are added to prepared and drawn from there when it is set.
+    uint32_t DrawPrimitives(const PrimitiveBatch& batch, const VertexStream& processed, const uint32_t* indices, uint32_t count,
+        uint32_t instance = 0, uint32_t stride = 1, std::vector<PreparedTriangle>* prepared = nullptr);
+
+    // Per vertex work, done once per vertex in batches over the whole stream
+    static void ProcessVertices(const VertexStream& input, VertexStream& output, const VertexStage& stage);
+    // Post transform stream of the next draw of the pass, inputSize vertices in with the current vertex stage.
+    // processVertices is cleared when an earlier pass of the frame already filled it for the same draw.
+    VertexStream& NextFrameStream(uint32_t inputSize, bool& processVertices);
+
+    PrimitiveBatch mBatch;
+
+    // Post transform polygon contours, reused between draws
+    std::vector<Vertex> mPolygonVertices;
+    std::vector<uint32_t> mPolygonContourEnds;
+
+    // Batch vertices expanded by the instance transforms, before the vertex stage
+    VertexStream mInstancedStream;
+
+    // Post transform vertices of the frame's draws in draw order, filled once per draw by ProcessVertices.
+    // Every pass of a frame runs the same script over the same variables, so its draws come in the same order,
+    // and a pass that only repairs a few tiles skips the vertex stage of draws an earlier pass processed.
+    struct FrameStream
+    {
+        VertexStage stage;
+        uint32_t inputSize = 0;
+        VertexStream processed;
+    };
+    std::vector<FrameStream> mFrameStreams;
+    uint32_t mFrameDrawCount = 0;
+    // Streams an earlier pass of this frame filled, none on the first pass
+    uint32_t mFilledFrameStreams = 0;
+
     bool mDrawBegin = false;
-};
\ No newline at end of file
+};
@@ -1,6 +1,214 @@
 #include "Rasterizer.h"
 
-void DrawLineHorizontal(const Vertex& left, const Vertex& right)
+#include "FrameBuffer.h"
+#include "Shader.h"
+#include "TriangleSetup.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    // Sub pixel steps per pixel for 28.4 fixed point positions
+    constexpr int64_t kSubPixelScale = 16;
+
+    int64_t FloorDiv(int64_t a, int64_t b)
+    {
+        const int64_t q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+
+    int64_t CeilDiv(int64_t a, int64_t b)
+    {
+        return -FloorDiv(-a, b);
+    }
+
+    // Bits of the lanes drawn in a group of 4 pixels ending at the span end
+    constexpr int kLaneMask[5] = { 0x0, 0x1, 0x3, 0x7, 0xf };
+
+    // floor and ceil without the library call SSE2 needs for them, v must fit an int
+    int FloorToInt(float v)
+    {
+        const int i = static_cast<int>(v);
+        return static_cast<float>(i) > v ? i - 1 : i;
+    }
+
+    int CeilToInt(float v)
+    {
+        const int i = static_cast<int>(v);
+        return static_cast<float>(i) < v ? i + 1 : i;
+    }
+
+    // Pixel spans of every row of a triangle in 28.4 fixed point with positive winding, one per sample offset,
+    // pixel x of row y covering the point (16x, 16y) moved by the offset.
+    // Edge function of edge a->b at pixel (x, y): dx * (16y - ay) - dy * (16x - ax) = value(y) - 16 * dy * x.
+    // Pixels exactly on an edge belong to the triangle only if it is a top or left edge,
+    // so triangles sharing an edge never both write a pixel.
+    // The span bound of a row is floor(value / |16 * dy|), kept as a quotient and remainder
+    // that step from row to row without dividing. An offset adds a constant to value,
+    // so each sample's bound is the quotient plus the offset's quotient and a carry from the remainders.
+    class TriangleRows
+    {
+    public:
+        TriangleRows(const int64_t px[3], const int64_t py[3], int64_t startY, const FrameBuffer::SampleOffset* offsets, int count)
+            : mCount(count)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                const int j = (i + 1) % 3;
+                const int64_t dx = px[j] - px[i];
+                const int64_t dy = py[j] - py[i];
+                const bool topLeft = dy < 0 || (dy == 0 && dx > 0);
+                const int64_t value = dx * (startY * kSubPixelScale - py[i]) + dy * px[i] + (topLeft ? 0 : -1);
+                const int64_t rowStep = dx * kSubPixelScale;
+
+                Edge& e = mEdges[i];
+                e.side = dy < 0 ? 1 : (dy > 0 ? -1 : 0);
+                e.divisor = dy != 0 ? std::abs(dy) * kSubPixelScale : 1;
+                e.quotient = FloorDiv(value, e.divisor);
+                e.remainder = value - e.quotient * e.divisor;
+                e.rowQuotient = FloorDiv(rowStep, e.divisor);
+                e.rowRemainder = rowStep - e.rowQuotient * e.divisor;
+                for (int s = 0; s < count; ++s)
+                {
+                    const int64_t offset = dx * offsets[s].y - dy * offsets[s].x;
+                    e.offsetQuotient[s] = FloorDiv(offset, e.divisor);
+                    e.offsetRemainder[s] = offset - e.offsetQuotient[s] * e.divisor;
+                }
+            }
+        }
+
+        // Exact span of the current row for each offset within [0, maxX], empty when start > end, then step to the next row
+        void NextRow(int64_t maxX, int64_t* startX, int64_t* endX)
+        {
+            std::fill_n(startX, mCount, int64_t(0));
+            std::fill_n(endX, mCount, maxX);
+            // Intersect the x ranges where each edge function passes
+            for (Edge& e : mEdges)
+            {
+                // An offset's remainder carries into the bound when it reaches what the row's remainder leaves of the divisor
+                const int64_t carryFrom = e.divisor - e.remainder;
+                if (e.side > 0)
+                {
+                    for (int s = 0; s < mCount; ++s)
+                    {
+                        const int64_t bound = e.quotient + e.offsetQuotient[s] + (e.offsetRemainder[s] >= carryFrom ? 1 : 0);
+                        startX[s] = std::max(startX[s], -bound);
+                    }
+                }
+                else if (e.side < 0)
+                {
+                    for (int s = 0; s < mCount; ++s)
+                    {
+                        const int64_t bound = e.quotient + e.offsetQuotient[s] + (e.offsetRemainder[s] >= carryFrom ? 1 : 0);
+                        endX[s] = std::min(endX[s], bound);
+                    }
+                }
+                else
+                {
+                    for (int s = 0; s < mCount; ++s)
+                    {
+                        const int64_t bound = e.quotient + e.offsetQuotient[s] + (e.offsetRemainder[s] >= carryFrom ? 1 : 0);
+                        endX[s] = bound < 0 ? -1 : endX[s];
+                    }
+                }
+
+                // The carry is taken without a branch, it follows the slope and would often be mispredicted
+                e.remainder += e.rowRemainder;
+                const int64_t carry = e.remainder >= e.divisor ? 1 : 0;
+                e.quotient += e.rowQuotient + carry;
+                e.remainder -= e.divisor & -carry;
+            }
+        }
+
+    private:
+        struct Edge
+        {
+            int64_t quotient, remainder, divisor;
+            int64_t rowQuotient, rowRemainder;
+            int64_t offsetQuotient[FrameBuffer::kMaxSampleCount];
+            int64_t offsetRemainder[FrameBuffer::kMaxSampleCount];
+            // 1 bounds the start of the span, -1 the end, 0 is a flat edge where only the sign matters
+            int side;
+        };
+        Edge mEdges[3];
+        int mCount;
+    };
+
+    // Add the signed area a line leaves to the right of it in each cell it crosses, and the rest of its cover to the next cell.
+    // A running sum along a row then gives the winding weighted coverage of each pixel.
+    // x must lie within [0, stride - 2], rows outside [0, rows) are skipped.
+    void AccumulateLine(float* coverage, int stride, int rows, Vector2 p0, Vector2 p1)
+    {
+        if (p0.y == p1.y)
+        {
+            return;
+        }
+        float direction = 1.0f;
+        if (p0.y > p1.y)
+        {
+            std::swap(p0, p1);
+            direction = -1.0f;
+        }
+
+        const float dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+        const int startY = std::max(FloorToInt(p0.y), 0);
+        const int endY = std::min(CeilToInt(p1.y), rows);
+        for (int y = startY; y < endY; ++y)
+        {
+            const float rowTop = std::max(static_cast<float>(y), p0.y);
+            const float rowBottom = std::min(static_cast<float>(y + 1), p1.y);
+            const float d = (rowBottom - rowTop) * direction;
+            const float xa = p0.x + (rowTop - p0.y) * dxdy;
+            const float xb = p0.x + (rowBottom - p0.y) * dxdy;
+            const float x0 = std::min(xa, xb);
+            const float x1 = std::max(xa, xb);
+            const int x0i = FloorToInt(x0);
+            const float x0Floor = static_cast<float>(x0i);
+            const int x1i = CeilToInt(x1);
+            float* row = coverage + y * stride;
+            if (x1i <= x0i + 1)
+            {
+                // Within one cell, the area right of the line is set by its mid point
+                const float xmf = 0.5f * (xa + xb) - x0Floor;
+                row[x0i] += d - d * xmf;
+                row[x0i + 1] += d * xmf;
+            }
+            else
+            {
+                // Across several cells, area grows linearly through the middle ones with a triangle at each end
+                const float s = 1.0f / (x1 - x0);
+                const float x0f = x0 - x0Floor;
+                const float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+                const float x1f = x1 - static_cast<float>(x1i) + 1.0f;
+                const float am = 0.5f * s * x1f * x1f;
+                row[x0i] += d * a0;
+                if (x1i == x0i + 2)
+                {
+                    row[x0i + 1] += d * (1.0f - a0 - am);
+                }
+                else
+                {
+                    const float a1 = s * (1.5f - x0f);
+                    row[x0i + 1] += d * (a1 - a0);
+                    for (int x = x0i + 2; x < x1i - 1; ++x)
+                    {
+                        row[x] += d * s;
+                    }
+                    const float a2 = a1 + static_cast<float>(x1i - x0i - 3) * s;
+                    row[x1i - 1] += d * (1.0f - a2 - am);
+                }
+                row[x1i] += d * am;
+            }
+        }
+    }
+}
+
+void DrawLineHorizontal(const Vertex& left, const Vertex& right, BlendMode mode)
 {
     float dx = right.pos.x - left.pos.x;
     int startX = static_cast<int>(left.pos.x);
@@ -10,11 +218,11 @@ void DrawLineHorizontal(const Vertex& left, const Vertex& right)
     {
         float t = static_cast<float>(x - startX) / dx;
         Vertex v = LerpVertex(left, right, t);
-        Rasterizer::Get()->DrawPoint(v);
+        FrameBuffer::Get()->SetPixel(static_cast<int>(v.pos.x), static_cast<int>(v.pos.y), v.color, mode);
     }
 }
 
-void DrawLineVertical(const Vertex& bottom, const Vertex& top)
+void DrawLineVertical(const Vertex& bottom, const Vertex& top, BlendMode mode)
 {
     float dy = top.pos.y - bottom.pos.y;
     int startY = static_cast<int>(bottom.pos.y);
@@ -24,7 +232,7 @@ void DrawLineVertical(const Vertex& bottom, const Vertex& top)
     {
         float t = static_cast<float>(y - startY) / dy;
         Vertex v = LerpVertex(bottom, top, t);
-        Rasterizer::Get()->DrawPoint(v);
+        FrameBuffer::Get()->SetPixel(static_cast<int>(v.pos.x), static_cast<int>(v.pos.y), v.color, mode);
     }
 }
 
@@ -34,6 +242,19 @@ Rasterizer* Rasterizer::Get()
     return &sInstance;
 }
 
+void Rasterizer::OnNewFrame()
+{
+    mTexture = nullptr;
+    mBlendMode = BlendMode::Opaque;
+    mFillMode = FillMode::Solid;
+    mShadeMode = ShadeMode::Gouraud;
+    mDepthTest = false;
+    mLineWidth = 1.0f;
+    mLineSmooth = false;
+    mShader = nullptr;
+    UpdateSpanKernel();
+}
+
 void Rasterizer::SetColor(X::Color color)
 {
     mColor = color;
@@ -41,23 +262,471 @@ void Rasterizer::SetColor(X::Color color)
 
 void Rasterizer::SetFillMode(FillMode fillmode)
 {
+    mFillMode = fillmode;
+}
+
+void Rasterizer::SetTexture(const Texture* texture)
+{
+    mTexture = texture;
+    UpdateSpanKernel();
+}
+
+void Rasterizer::SetTextureFilter(TextureFilter filter)
+{
+    mTextureFilter = filter;
+}
+
+void Rasterizer::SetBlendMode(BlendMode mode)
+{
+    mBlendMode = mode;
+    UpdateSpanKernel();
+}
+
+void Rasterizer::SetShadeMode(ShadeMode mode)
+{
+    mShadeMode = mode;
+    UpdateSpanKernel();
+}
+
+void Rasterizer::SetLineWidth(float width)
+{
+    // Thinner lines would fade out rather than get thinner
+    constexpr float kMaxLineWidth = 32.0f;
+    mLineWidth = std::clamp(width, 1.0f, kMaxLineWidth);
+}
+
+void Rasterizer::SetLineSmooth(bool enabled)
+{
+    mLineSmooth = enabled;
+}
 
+void Rasterizer::SetDepthTest(bool enabled)
+{
+    mDepthTest = enabled;
+    UpdateSpanKernel();
+}
+
+void Rasterizer::SetShader(const Shader* shader)
+{
+    mShader = shader;
+    UpdateSpanKernel();
 }
 
 void Rasterizer::DrawPoint(int x, int y)
 {
-    X::DrawPixel(x, y, mColor);
+    const int point[2] = { x, y };
+    const float px = static_cast<float>(x);
+    const float py = static_cast<float>(y);
+    if (!TrackDraw(px, py, px, py, FrameBuffer::HashInput(point, sizeof(point))))
+    {
+        return;
+    }
+    FrameBuffer::Get()->SetPixel(x, y, mColor, mBlendMode);
 }
 
 void Rasterizer::DrawPoint(const Vertex& vertex)
 {
+    if (!TrackDraw(vertex.pos.x, vertex.pos.y, vertex.pos.x, vertex.pos.y, FrameBuffer::HashInput(&vertex, sizeof(vertex))))
+    {
+        return;
+    }
+
     int x = static_cast<int>(vertex.pos.x);
     int y = static_cast<int>(vertex.pos.y);
-    X::DrawPixel(x, y, vertex.color);
+    FrameBuffer::Get()->SetPixel(x, y, vertex.color, mBlendMode);
+}
+
+void Rasterizer::DrawEllipse(float x, float y, float radiusX, float radiusY, bool filled, bool antiAliased)
+{
+    // NaN and infinite values draw nothing, radii are capped like triangle coordinates so row math stays in range
+    constexpr float kMaxRadius = static_cast<float>(1 << 22);
+    if (!std::isfinite(x) || !std::isfinite(y) || !(radiusX >= 0.0f && radiusY >= 0.0f) || !std::isfinite(radiusX) || !std::isfinite(radiusY))
+    {
+        return;
+    }
+    radiusX = std::min(radiusX, kMaxRadius);
+    radiusY = std::min(radiusY, kMaxRadius);
+
+    // A tracked draw reaches the buffer, so the center is within a radius of it and fits an int
+    const float shape[4] = { x, y, radiusX, radiusY };
+    const uint8_t style[2] = { filled, antiAliased };
+    if (!TrackDraw(x - radiusX, y - radiusY, x + radiusX, y + radiusY, FrameBuffer::HashInput(style, sizeof(style), FrameBuffer::HashInput(shape, sizeof(shape)))))
+    {
+        return;
+    }
+
+    if (antiAliased)
+    {
+        DrawSmoothEllipse(x, y, radiusX, radiusY, filled);
+    }
+    else
+    {
+        DrawMidpointEllipse(static_cast<int>(std::floor(x + 0.5f)), static_cast<int>(std::floor(y + 0.5f)),
+            static_cast<int>(radiusX + 0.5f), static_cast<int>(radiusY + 0.5f), filled);
+    }
+}
+
+void Rasterizer::DrawMidpointEllipse(int x, int y, int radiusX, int radiusY, bool filled)
+{
+    FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const int width = static_cast<int>(frameBuffer->GetWidth());
+
+    // Half width of the row dy away from the center, -1 past the ends. Like the midpoint walk, a row reaches the
+    // pixel nearest the curve on steep parts and runs out to where the curve crosses the half row on flat parts.
+    // Only rows on the buffer are solved, so the cost follows the rows covered and not the radius.
+    auto rowExtent = [&](int dy) -> int64_t
+    {
+        if (dy > radiusY)
+        {
+            return -1;
+        }
+        if (dy == 0 || radiusY == 0)
+        {
+            return radiusX;
+        }
+        auto curveX = [&](double rowY)
+        {
+            const double t = rowY / radiusY;
+            return radiusX * std::sqrt(std::max(1.0 - t * t, 0.0));
+        };
+        return static_cast<int64_t>(std::max(std::floor(curveX(dy) + 0.5), std::floor(curveX(dy - 0.5))));
+    };
+    auto fillSpan = [&](int rowY, int64_t startX, int64_t endX)
+    {
+        frameBuffer->FillSpan(rowY, static_cast<int>(std::max<int64_t>(startX, -1)), static_cast<int>(std::min<int64_t>(endX, width)), mColor, mBlendMode);
+    };
+
+    const int top = std::max(y - radiusY, 0);
+    const int bottom = std::min(y + radiusY, static_cast<int>(frameBuffer->GetHeight()) - 1);
+    for (int rowY = top; rowY <= bottom; ++rowY)
+    {
+        const int dy = std::abs(rowY - y);
+        const int64_t outer = rowExtent(dy);
+        // An outline row runs in from its end to just past the end of the row beyond it, which keeps it 8-connected
+        const int64_t inner = std::min(outer, rowExtent(dy + 1) + 1);
+        if (filled || inner == 0)
+        {
+            fillSpan(rowY, x - outer, x + outer);
+        }
+        else
+        {
+            fillSpan(rowY, x - outer, x - inner);
+            fillSpan(rowY, x + inner, x + outer);
+        }
+    }
+}
+
+void Rasterizer::DrawSmoothEllipse(float x, float y, float radiusX, float radiusY, bool filled)
+{
+    FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const int width = static_cast<int>(frameBuffer->GetWidth());
+    const int height = static_cast<int>(frameBuffer->GetHeight());
+    // Doubles keep the distance to the curve accurate to a fraction of a pixel on large radii
+    const double rx = std::max(radiusX, 0.5f);
+    const double ry = std::max(radiusY, 0.5f);
+    const double invRx2 = 1.0 / (rx * rx);
+    const double invRy2 = 1.0 / (ry * ry);
+
+    // Half width of the row through dy on an ellipse grown by margin, negative when the row misses it
+    auto halfWidth = [&](double dy, double margin)
+    {
+        const double grownX = rx + margin;
+        const double grownY = ry + margin;
+        if (grownX <= 0.0 || grownY <= 0.0 || std::abs(dy) >= grownY)
+        {
+            return -1.0;
+        }
+        return grownX * std::sqrt(1.0 - (dy * dy) / (grownY * grownY));
+    };
+    auto shadePixel = [&](int column, int row, double dy)
+    {
+        const double dx = static_cast<double>(column) - x;
+        const double f = dx * dx * invRx2 + dy * dy * invRy2 - 1.0;
+        const double gradient = 2.0 * std::sqrt(dx * dx * invRx2 * invRx2 + dy * dy * invRy2 * invRy2);
+        const double distance = gradient > 0.0 ? f / gradient : -rx;
+        const double coverage = filled ? 0.5 - distance : 1.0 - std::abs(distance);
+        DrawCoveredPixel(column, row, mColor, static_cast<float>(std::min(coverage, 1.0)));
+    };
+
+    // Coverage only changes within a pixel of the curve. Pixels between the ellipses grown and shrunk by 2 are
+    // shaded from the implicit function over its gradient, which is the distance to the curve near it.
+    // Rows and columns are clipped to the buffer first, so only covered pixels cost anything.
+    constexpr double kBand = 2.0;
+    const int top = std::max(static_cast<int>(std::floor(y - ry - kBand)), 0);
+    const int bottom = std::min(static_cast<int>(std::ceil(y + ry + kBand)), height - 1);
+    for (int row = top; row <= bottom; ++row)
+    {
+        const double dy = static_cast<double>(row) - y;
+        const double outer = halfWidth(dy, kBand);
+        if (outer < 0.0)
+        {
+            continue;
+        }
+        const int outerLeft = static_cast<int>(std::max(std::floor(x - outer), 0.0));
+        const int outerRight = static_cast<int>(std::min(std::ceil(x + outer), width - 1.0));
+
+        // Near the tips or off a fractional centre the inner row can fall between two pixel centres and be empty
+        int innerLeft = outerRight + 1;
+        int innerRight = outerRight;
+        const double inner = halfWidth(dy, -kBand);
+        if (inner >= 0.0 && std::ceil(x - inner) <= std::floor(x + inner))
+        {
+            innerLeft = static_cast<int>(std::clamp(std::ceil(x - inner), outerLeft - 0.0, outerRight + 1.0));
+            innerRight = static_cast<int>(std::clamp(std::floor(x + inner), outerLeft - 1.0, outerRight + 0.0));
+            if (filled && innerLeft <= innerRight)
+            {
+                frameBuffer->FillSpan(row, innerLeft, innerRight, mColor, mBlendMode);
+            }
+        }
+
+        for (int column = outerLeft; column <= outerRight && column < innerLeft; ++column)
+        {
+            shadePixel(column, row, dy);
+        }
+        for (int column = std::max(innerRight + 1, outerLeft); column <= outerRight; ++column)
+        {
+            shadePixel(column, row, dy);
+        }
+    }
+}
+
+void Rasterizer::DrawCoveredPixel(int x, int y, const X::Color& pixelColor, float coverage)
+{
+    if (coverage <= 0.0f)
+    {
+        return;
+    }
+
+    if (coverage >= 1.0f)
+    {
+        FrameBuffer::Get()->SetPixel(x, y, pixelColor, mBlendMode);
+        return;
+    }
+
+    X::Color color = pixelColor;
+    color.a *= coverage;
+    BlendMode mode = mBlendMode;
+    if (mode == BlendMode::Opaque)
+    {
+        mode = BlendMode::Alpha;
+    }
+    else if (mode == BlendMode::Premultiplied)
+    {
+        color.r *= coverage;
+        color.g *= coverage;
+        color.b *= coverage;
+    }
+    FrameBuffer::Get()->SetPixel(x, y, color, mode);
+}
+
+void Rasterizer::FillPath(const std::vector<Vector2>& points, const std::vector<uint32_t>& contourEnds, FillRule rule)
+{
+    if (points.empty())
+    {
+        return;
+    }
+
+    // Only the part of the bounds on the target gets a coverage buffer
+    Vector2 minPoint = points.front();
+    Vector2 maxPoint = points.front();
+    for (const Vector2& p : points)
+    {
+        minPoint = { std::min(minPoint.x, p.x), std::min(minPoint.y, p.y) };
+        maxPoint = { std::max(maxPoint.x, p.x), std::max(maxPoint.y, p.y) };
+    }
+    uint64_t hash = FrameBuffer::HashInput(points.data(), points.size() * sizeof(Vector2));
+    hash = FrameBuffer::HashInput(contourEnds.data(), contourEnds.size() * sizeof(uint32_t), hash);
+    if (!TrackDraw(minPoint.x, minPoint.y, maxPoint.x, maxPoint.y, FrameBuffer::HashInput(&rule, sizeof(rule), hash)))
+    {
+        return;
+    }
+
+    const FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const float targetWidth = static_cast<float>(frameBuffer->GetWidth());
+    const float targetHeight = static_cast<float>(frameBuffer->GetHeight());
+    const int left = static_cast<int>(std::clamp(std::floor(minPoint.x), 0.0f, targetWidth));
+    const int top = static_cast<int>(std::clamp(std::floor(minPoint.y), 0.0f, targetHeight));
+    const int right = static_cast<int>(std::clamp(std::ceil(maxPoint.x), 0.0f, targetWidth));
+    const int bottom = static_cast<int>(std::clamp(std::ceil(maxPoint.y), 0.0f, targetHeight));
+    if (left >= right || top >= bottom)
+    {
+        return;
+    }
+
+    // One spare column takes the cover of edges on the right border, another the area spilling past it.
+    // Rows are padded to whole SIMD groups.
+    const int width = right - left;
+    const int rows = bottom - top;
+    const int stride = (width + 2 + 3) & ~3;
+    mCoverage.assign(static_cast<size_t>(stride) * rows, 0.0f);
+
+    // Parts of an edge left or right of the buffer become vertical lines on its border.
+    // They still change the winding of the pixels to their right, which is all that matters there.
+    const Vector2 origin(static_cast<float>(left), static_cast<float>(top));
+    const float maxX = static_cast<float>(width);
+    auto addEdge = [&](Vector2 p0, Vector2 p1)
+    {
+        p0 -= origin;
+        p1 -= origin;
+        float cuts[4] = { 0.0f, 1.0f, 1.0f, 1.0f };
+        int cutCount = 1;
+        for (float border : { 0.0f, maxX })
+        {
+            if ((p0.x < border) != (p1.x < border))
+            {
+                cuts[cutCount++] = (border - p0.x) / (p1.x - p0.x);
+            }
+        }
+        std::sort(cuts + 1, cuts + cutCount);
+        cuts[cutCount] = 1.0f;
+        for (int i = 0; i < cutCount; ++i)
+        {
+            Vector2 a = p0 + (p1 - p0) * cuts[i];
+            Vector2 b = p0 + (p1 - p0) * cuts[i + 1];
+            a.x = std::clamp(a.x, 0.0f, maxX);
+            b.x = std::clamp(b.x, 0.0f, maxX);
+            AccumulateLine(mCoverage.data(), stride, rows, a, b);
+        }
+    };
+    uint32_t contourStart = 0;
+    for (uint32_t contourEnd : contourEnds)
+    {
+        for (uint32_t i = contourStart; i < contourEnd; ++i)
+        {
+            addEdge(points[i], points[i + 1 < contourEnd ? i + 1 : contourStart]);
+        }
+        contourStart = contourEnd;
+    }
+
+    // Coverage is the absolute winding, folded back down past 1 for even-odd
+    auto drawRow = &Rasterizer::DrawCoverageRow<BlendMode::Opaque>;
+    switch (mBlendMode)
+    {
+    case BlendMode::Alpha: drawRow = &Rasterizer::DrawCoverageRow<BlendMode::Alpha>; break;
+    case BlendMode::Additive: drawRow = &Rasterizer::DrawCoverageRow<BlendMode::Additive>; break;
+    case BlendMode::Multiply: drawRow = &Rasterizer::DrawCoverageRow<BlendMode::Multiply>; break;
+    case BlendMode::Premultiplied: drawRow = &Rasterizer::DrawCoverageRow<BlendMode::Premultiplied>; break;
+    default: break;
+    }
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    for (int y = 0; y < rows; ++y)
+    {
+        // Running sum 4 cells at a time, the last lane carries into the next group
+        float* row = mCoverage.data() + static_cast<size_t>(y) * stride;
+        __m128 carry = _mm_setzero_ps();
+        for (int x = 0; x < width; x += 4)
+        {
+            __m128 sum = _mm_loadu_ps(row + x);
+            sum = _mm_add_ps(sum, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sum), 4)));
+            sum = _mm_add_ps(sum, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sum), 8)));
+            sum = _mm_add_ps(sum, carry);
+            carry = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 3, 3, 3));
+
+            __m128 coverage = _mm_andnot_ps(signBit, sum);
+            if (rule == FillRule::EvenOdd)
+            {
+                const __m128 pairs = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(coverage, _mm_set1_ps(0.5f))));
+                coverage = _mm_sub_ps(coverage, _mm_mul_ps(pairs, two));
+                coverage = _mm_min_ps(coverage, _mm_sub_ps(two, coverage));
+            }
+            _mm_storeu_ps(row + x, _mm_min_ps(coverage, one));
+        }
+        (this->*drawRow)(top + y, left, row, width);
+    }
+}
+
+template <BlendMode Mode>
+void Rasterizer::DrawCoverageRow(int y, int left, const float* coverage, int width)
+{
+    // Partly covered pixels blend by their coverage, opaque drawing included
+    constexpr BlendMode EdgeMode = Mode == BlendMode::Opaque ? BlendMode::Alpha : Mode;
+    constexpr float kFullCoverage = 1.0f - 1.0f / 512.0f;
+    constexpr float kNoCoverage = 1.0f / 512.0f;
+
+    FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const __m128 colorR = _mm_set1_ps(mColor.r);
+    const __m128 colorG = _mm_set1_ps(mColor.g);
+    const __m128 colorB = _mm_set1_ps(mColor.b);
+    const __m128 colorA = _mm_set1_ps(mColor.a);
+    const uint32_t fullPixel = static_cast<uint32_t>(_mm_cvtsi128_si32(FrameBuffer::PackColors(colorR, colorG, colorB, colorA)));
+    const __m128 depth = _mm_setzero_ps();
+
+    // Groups of 4 pixels: fully covered lanes extend the current span, partly covered ones are blended together
+    int runStart = -1;
+    for (int x = 0; x < width; x += 4)
+    {
+        const int validMask = kLaneMask[std::min(width - x, 4)];
+        const __m128 laneCoverage = _mm_loadu_ps(coverage + x);
+        const int fullMask = _mm_movemask_ps(_mm_cmpge_ps(laneCoverage, _mm_set1_ps(kFullCoverage))) & validMask;
+        const int edgeMask = _mm_movemask_ps(_mm_cmpgt_ps(laneCoverage, _mm_set1_ps(kNoCoverage))) & validMask & ~fullMask;
+        if (fullMask == 0xf)
+        {
+            runStart = runStart < 0 ? x : runStart;
+            continue;
+        }
+        if (fullMask == 0 && edgeMask == 0 && runStart < 0)
+        {
+            continue;
+        }
+
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            if ((fullMask >> lane) & 1)
+            {
+                runStart = runStart < 0 ? x + lane : runStart;
+            }
+            else if (runStart >= 0)
+            {
+                frameBuffer->FillSpan<Mode>(y, left + runStart, left + x + lane - 1, fullPixel);
+                runStart = -1;
+            }
+        }
+
+        if (edgeMask != 0)
+        {
+            __m128 r = colorR;
+            __m128 g = colorG;
+            __m128 b = colorB;
+            if (Mode == BlendMode::Premultiplied)
+            {
+                r = _mm_mul_ps(r, laneCoverage);
+                g = _mm_mul_ps(g, laneCoverage);
+                b = _mm_mul_ps(b, laneCoverage);
+            }
+            const __m128i pixels = FrameBuffer::PackColors(r, g, b, _mm_mul_ps(colorA, laneCoverage));
+            frameBuffer->WritePixels<EdgeMode, false>(left + x, y, edgeMask, pixels, depth);
+        }
+    }
+    if (runStart >= 0)
+    {
+        frameBuffer->FillSpan<Mode>(y, left + runStart, left + width - 1, fullPixel);
+    }
+}
+
+void Rasterizer::FloodFill(int x, int y, float tolerance)
+{
+    FrameBuffer::Get()->FloodFill(x, y, mColor, tolerance, mBlendMode);
 }
 
 void Rasterizer::DrawLine(const Vertex& a, const Vertex& b)
 {
+    if (TrackDraw(std::min(a.pos.x, b.pos.x), std::min(a.pos.y, b.pos.y), std::max(a.pos.x, b.pos.x), std::max(a.pos.y, b.pos.y),
+        FrameBuffer::HashInput(&b, sizeof(b), FrameBuffer::HashInput(&a, sizeof(a)))))
+    {
+        RasterizeLine(a, b);
+    }
+}
+
+void Rasterizer::RasterizeLine(const Vertex& a, const Vertex& b)
+{
+    if (mLineSmooth || mLineWidth > 1.0f)
+    {
+        DrawCoverageLine(a, b);
+        return;
+    }
+
     float dx = b.pos.x - a.pos.x;
     float dy = b.pos.y - a.pos.y;
 
@@ -66,11 +735,11 @@ void Rasterizer::DrawLine(const Vertex& a, const Vertex& b)
     {
         if (a.pos.y < b.pos.y)
         {
-            DrawLineVertical(a, b);
+            DrawLineVertical(a, b, mBlendMode);
         }
         else
         {
-            DrawLineVertical(b, a);
+            DrawLineVertical(b, a, mBlendMode);
         }
     }
     // Line is going more horinzontally than vertically
@@ -78,36 +747,160 @@ void Rasterizer::DrawLine(const Vertex& a, const Vertex& b)
     {
         if (a.pos.x < b.pos.x)
         {
-            DrawLineHorizontal(a, b);
+            DrawLineHorizontal(a, b, mBlendMode);
         }
         else
         {
-            DrawLineHorizontal(b, a);
+            DrawLineHorizontal(b, a, mBlendMode);
+        }
+    }
+}
+
+void Rasterizer::DrawCoverageLine(const Vertex& a, const Vertex& b)
+{
+    // Walk the major axis one pixel at a time like Wu's algorithm, with a run of pixels across it instead of two
+    const bool steep = std::abs(b.pos.y - a.pos.y) > std::abs(b.pos.x - a.pos.x);
+    const Vertex* start = &a;
+    const Vertex* end = &b;
+    auto major = [steep](const Vertex& v) { return steep ? v.pos.y : v.pos.x; };
+    auto minor = [steep](const Vertex& v) { return steep ? v.pos.x : v.pos.y; };
+    if (major(*start) > major(*end))
+    {
+        std::swap(start, end);
+    }
+
+    const float majorStart = major(*start);
+    const float majorEnd = major(*end);
+    const float length = majorEnd - majorStart;
+    const float slope = length > 0.0f ? (minor(*end) - minor(*start)) / length : 0.0f;
+    // Half the width measured along the minor axis, wider than the line's half width when it is slanted
+    const float halfExtent = 0.5f * mLineWidth * std::sqrt(1.0f + slope * slope);
+
+    // Pixel (x, y) covers the square around the point (x, y), the line ends flat at its end points
+    const FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const float majorLimit = static_cast<float>(steep ? frameBuffer->GetHeight() : frameBuffer->GetWidth());
+    const float minorLimit = static_cast<float>(steep ? frameBuffer->GetWidth() : frameBuffer->GetHeight());
+    const int first = FloorToInt(std::max(majorStart + 0.5f, 0.0f));
+    const int last = FloorToInt(std::min(majorEnd + 0.5f, majorLimit));
+    for (int m = first; m <= last; ++m)
+    {
+        const float pixel = static_cast<float>(m);
+        const float along = std::min(pixel + 0.5f, majorEnd) - std::max(pixel - 0.5f, majorStart);
+        // Zero length lines still draw a square of the line width
+        const float alongCoverage = length > 0.0f ? std::min(along, 1.0f) : 1.0f;
+        if (alongCoverage <= 0.0f)
+        {
+            continue;
+        }
+
+        const float t = length > 0.0f ? std::clamp((pixel - majorStart) / length, 0.0f, 1.0f) : 0.0f;
+        const float center = minor(*start) + slope * (t * length);
+        const X::Color color = LerpColor(start->color, end->color, t);
+        const int low = FloorToInt(std::max(center - halfExtent + 0.5f, 0.0f));
+        const int high = FloorToInt(std::min(center + halfExtent + 0.5f, minorLimit));
+        for (int n = low; n <= high; ++n)
+        {
+            const float across = std::min(static_cast<float>(n) + 0.5f, center + halfExtent) - std::max(static_cast<float>(n) - 0.5f, center - halfExtent);
+            float coverage = std::min(across, 1.0f) * alongCoverage;
+            if (!mLineSmooth)
+            {
+                // Wide aliased lines keep the pixels at least half covered
+                coverage = coverage >= 0.5f ? 1.0f : 0.0f;
+            }
+            DrawCoveredPixel(steep ? n : m, steep ? m : n, color, coverage);
         }
     }
 }
 
 void Rasterizer::DrawTriangle(const Vertex& a, const Vertex& b, const Vertex& c)
 {
+    const float minX = std::min({ a.pos.x, b.pos.x, c.pos.x });
+    const float minY = std::min({ a.pos.y, b.pos.y, c.pos.y });
+    const float maxX = std::max({ a.pos.x, b.pos.x, c.pos.x });
+    const float maxY = std::max({ a.pos.y, b.pos.y, c.pos.y });
+    const uint64_t hash = FrameBuffer::HashInput(&c, sizeof(c), FrameBuffer::HashInput(&b, sizeof(b), FrameBuffer::HashInput(&a, sizeof(a))));
+    if (!TrackDraw(minX, minY, maxX, maxY, hash))
+    {
+        return;
+    }
+
     switch (mFillMode)
     {
     case FillMode::Wireframe:
     {
-        DrawLine(a, b);
-        DrawLine(b, c);
-        DrawLine(c, a);
+        RasterizeLine(a, b);
+        RasterizeLine(b, c);
+        RasterizeLine(c, a);
     }
     break;
     case FillMode::Solid:
     {
-        std::vector<Vertex> sortedVertices = { a, b, c };
-        std::sort(sortedVertices.begin(), sortedVertices.end(),
-            [](const Vertex& lhs, const Vertex& rhs)
-            {
-                return lhs.pos.y < rhs.pos.y;
-            });
+        DrawFilledTriangle(a, b, c);
+    }
+    break;
+    default:
+        break;
+    }
+}
+
+void Rasterizer::PrepareTriangle(const Vertex& a, const Vertex& b, const Vertex& c, PreparedTriangle& prepared) const
+{
+    prepared.minX = std::min({ a.pos.x, b.pos.x, c.pos.x });
+    prepared.minY = std::min({ a.pos.y, b.pos.y, c.pos.y });
+    prepared.maxX = std::max({ a.pos.x, b.pos.x, c.pos.x });
+    prepared.maxY = std::max({ a.pos.y, b.pos.y, c.pos.y });
+    prepared.hash = FrameBuffer::HashInput(&c, sizeof(c), FrameBuffer::HashInput(&b, sizeof(b), FrameBuffer::HashInput(&a, sizeof(a))));
+    prepared.hasArea = SetupFilledTriangle(a, b, c, prepared.setup, prepared.px, prepared.py);
+    prepared.flatColor = a.color;
+}
+
+void Rasterizer::DrawPreparedTriangle(const PreparedTriangle& prepared)
+{
+    // Tracked with the same bounds and hash as DrawTriangle, so tiles hash the same whichever way they are drawn
+    if (TrackDraw(prepared.minX, prepared.minY, prepared.maxX, prepared.maxY, prepared.hash) && prepared.hasArea)
+    {
+        RasterizeFilledTriangle(prepared.setup, prepared.flatColor, prepared.px, prepared.py);
+    }
+}
+
+void Rasterizer::DrawPolygon(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& contourEnds, FillRule rule)
+{
+    if (vertices.empty())
+    {
+        return;
+    }
+    Vector2 minPoint = { vertices.front().pos.x, vertices.front().pos.y };
+    Vector2 maxPoint = minPoint;
+    for (const Vertex& v : vertices)
+    {
+        minPoint = { std::min(minPoint.x, v.pos.x), std::min(minPoint.y, v.pos.y) };
+        maxPoint = { std::max(maxPoint.x, v.pos.x), std::max(maxPoint.y, v.pos.y) };
+    }
+    uint64_t hash = FrameBuffer::HashInput(vertices.data(), vertices.size() * sizeof(Vertex));
+    hash = FrameBuffer::HashInput(contourEnds.data(), contourEnds.size() * sizeof(uint32_t), hash);
+    if (!TrackDraw(minPoint.x, minPoint.y, maxPoint.x, maxPoint.y, FrameBuffer::HashInput(&rule, sizeof(rule), hash)))
+    {
+        return;
+    }
 
-        DrawFilledTriangle(sortedVertices[0], sortedVertices[1], sortedVertices[2]);
+    switch (mFillMode)
+    {
+    case FillMode::Wireframe:
+    {
+        uint32_t contourStart = 0;
+        for (uint32_t contourEnd : contourEnds)
+        {
+            for (uint32_t i = contourStart; i < contourEnd; ++i)
+            {
+                RasterizeLine(vertices[i], vertices[i + 1 < contourEnd ? i + 1 : contourStart]);
+            }
+            contourStart = contourEnd;
+        }
+    }
+    break;
+    case FillMode::Solid:
+    {
+        DrawFilledPolygon(vertices, contourEnds, rule);
     }
     break;
     default:
@@ -115,46 +908,588 @@ void Rasterizer::DrawTriangle(const Vertex& a, const Vertex& b, const Vertex& c)
     }
 }
 
+void Rasterizer::DrawFilledPolygon(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& contourEnds, FillRule rule)
+{
+    constexpr float kMaxCoordinate = static_cast<float>(1 << 22);
+    for (const Vertex& v : vertices)
+    {
+        if (!(fabsf(v.pos.x) < kMaxCoordinate && fabsf(v.pos.y) < kMaxCoordinate))
+        {
+            return;
+        }
+    }
+
+    // Same sampling as triangles: 28.4 snapped positions, pixel (x, y) samples the point (x, y).
+    // A row takes the edges with top <= y < bottom and a span covers left <= x < right,
+    // so shapes sharing an edge never both write a pixel.
+    struct Edge
+    {
+        int64_t x, y, dx, dy;
+        int64_t topRow, endRow;
+        // First pixel at or right of the edge on the current row
+        int64_t crossing;
+        // +1 for edges going down the screen, -1 for edges going up
+        int winding;
+    };
+    std::vector<Edge> edges;
+    edges.reserve(vertices.size());
+    uint32_t contourStart = 0;
+    for (uint32_t contourEnd : contourEnds)
+    {
+        for (uint32_t i = contourStart; i < contourEnd; ++i)
+        {
+            const Vertex& a = vertices[i];
+            const Vertex& b = vertices[i + 1 < contourEnd ? i + 1 : contourStart];
+            int64_t ax = static_cast<int64_t>(lroundf(a.pos.x * kSubPixelScale));
+            int64_t ay = static_cast<int64_t>(lroundf(a.pos.y * kSubPixelScale));
+            int64_t bx = static_cast<int64_t>(lroundf(b.pos.x * kSubPixelScale));
+            int64_t by = static_cast<int64_t>(lroundf(b.pos.y * kSubPixelScale));
+            if (ay == by)
+            {
+                // Flat edges never cross a row
+                continue;
+            }
+
+            const int winding = ay < by ? 1 : -1;
+            if (ay > by)
+            {
+                std::swap(ax, bx);
+                std::swap(ay, by);
+            }
+            const int64_t topRow = CeilDiv(ay, kSubPixelScale);
+            const int64_t endRow = CeilDiv(by, kSubPixelScale);
+            if (topRow < endRow)
+            {
+                edges.push_back({ ax, ay, bx - ax, by - ay, topRow, endRow, 0, winding });
+            }
+        }
+        contourStart = contourEnd;
+    }
+    if (edges.empty())
+    {
+        return;
+    }
+
+    // Sorted edge table, edges enter the active list in order of their top row
+    std::sort(edges.begin(), edges.end(), [](const Edge& lhs, const Edge& rhs) { return lhs.topRow < rhs.topRow; });
+
+    const FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const int64_t maxY = static_cast<int64_t>(frameBuffer->GetHeight()) - 1;
+    int64_t endY = 0;
+    for (const Edge& edge : edges)
+    {
+        endY = std::max(endY, edge.endRow - 1);
+    }
+    endY = std::min(endY, maxY);
+
+    const X::Color color = vertices.front().color;
+    std::vector<Edge*> active;
+    size_t nextEdge = 0;
+    for (int64_t y = std::max<int64_t>(edges.front().topRow, 0); y <= endY; ++y)
+    {
+        // Retire finished edges and let new ones in, edges starting above the target join at the first visible row
+        active.erase(std::remove_if(active.begin(), active.end(), [y](const Edge* edge) { return edge->endRow <= y; }), active.end());
+        for (; nextEdge < edges.size() && edges[nextEdge].topRow <= y; ++nextEdge)
+        {
+            if (edges[nextEdge].endRow > y)
+            {
+                active.push_back(&edges[nextEdge]);
+            }
+        }
+
+        // Exact integer crossing, ceil((x + (16y - y0) * dx / dy) / 16), so rounding never moves a pixel across an edge
+        for (Edge* edge : active)
+        {
+            edge->crossing = CeilDiv(edge->x * edge->dy + (y * kSubPixelScale - edge->y) * edge->dx, edge->dy * kSubPixelScale);
+        }
+
+        // Crossings barely move between rows, so insertion sort is close to linear
+        for (size_t i = 1; i < active.size(); ++i)
+        {
+            Edge* edge = active[i];
+            size_t j = i;
+            for (; j > 0 && active[j - 1]->crossing > edge->crossing; --j)
+            {
+                active[j] = active[j - 1];
+            }
+            active[j] = edge;
+        }
+
+        // Walk the crossings left to right, spans run between the points where the fill rule flips
+        int winding = 0;
+        int64_t spanStart = 0;
+        for (const Edge* edge : active)
+        {
+            const bool wasInside = rule == FillRule::EvenOdd ? (winding & 1) != 0 : winding != 0;
+            winding += edge->winding;
+            const bool isInside = rule == FillRule::EvenOdd ? (winding & 1) != 0 : winding != 0;
+            if (!wasInside && isInside)
+            {
+                spanStart = edge->crossing;
+            }
+            else if (wasInside && !isInside && spanStart < edge->crossing)
+            {
+                FrameBuffer::Get()->FillSpan(static_cast<int>(y), static_cast<int>(std::max<int64_t>(spanStart, -1)),
+                    static_cast<int>(std::min<int64_t>(edge->crossing, frameBuffer->GetWidth())) - 1, color, mBlendMode);
+            }
+        }
+    }
+}
+
 void Rasterizer::DrawFilledTriangle(const Vertex& a, const Vertex& b, const Vertex& c)
 {
-    // highest delta y
-    float dy = c.pos.y - a.pos.y;
-    // if a and b are the same, flat top
-    if (MathHelper::CheckEqual(a.pos.y, b.pos.y))
+    TriangleSetup setup;
+    int64_t px[3], py[3];
+    if (SetupFilledTriangle(a, b, c, setup, px, py))
+    {
+        // Flat shading takes the first vertex as given, before the winding swap
+        RasterizeFilledTriangle(setup, a.color, px, py);
+    }
+}
+
+bool Rasterizer::SetupFilledTriangle(const Vertex& a, const Vertex& b, const Vertex& c, TriangleSetup& setup, int64_t px[3], int64_t py[3])
+{
+    // Larger coordinates would overflow the fixed point edge math, there is no guard band clipping
+    constexpr float kMaxCoordinate = static_cast<float>(1 << 22);
+    for (const Vertex* v : { &a, &b, &c })
+    {
+        if (!(fabsf(v->pos.x) < kMaxCoordinate && fabsf(v->pos.y) < kMaxCoordinate))
+        {
+            return false;
+        }
+    }
+
+    // Snap to 28.4 fixed point, everything about coverage below is exact integer math
+    Vertex snapped[3] = { a, b, c };
+    for (int i = 0; i < 3; ++i)
+    {
+        px[i] = static_cast<int64_t>(lroundf(snapped[i].pos.x * kSubPixelScale));
+        py[i] = static_cast<int64_t>(lroundf(snapped[i].pos.y * kSubPixelScale));
+        snapped[i].pos.x = static_cast<float>(px[i]) / kSubPixelScale;
+        snapped[i].pos.y = static_cast<float>(py[i]) / kSubPixelScale;
+    }
+
+    // Make the winding consistent so inside is where every edge function is positive
+    const int64_t area = (px[1] - px[0]) * (py[2] - py[0]) - (px[2] - px[0]) * (py[1] - py[0]);
+    if (area == 0)
+    {
+        return false;
+    }
+    if (area < 0)
+    {
+        std::swap(snapped[1], snapped[2]);
+        std::swap(px[1], px[2]);
+        std::swap(py[1], py[2]);
+    }
+    return setup.Initialize(snapped[0], snapped[1], snapped[2]);
+}
+
+void Rasterizer::RasterizeFilledTriangle(const TriangleSetup& setup, const X::Color& flatColor, const int64_t px[3], const int64_t py[3])
+{
+    const SpanKernel drawSpan = mSpanKernel;
+    const FrameBuffer* frameBuffer = FrameBuffer::Get();
+    if (frameBuffer->GetSampleCount() > 1)
     {
-        int startY = static_cast<int>(a.pos.y);
-        int endY = static_cast<int>(c.pos.y);
+        DrawMultisampleTriangle(setup, flatColor, px, py);
+        return;
+    }
 
-        for (int y = startY; y <= endY; ++y)
+    // Pixel (x, y) samples the point (x, y)
+    const int64_t maxX = static_cast<int64_t>(frameBuffer->GetWidth()) - 1;
+    const int64_t maxY = static_cast<int64_t>(frameBuffer->GetHeight()) - 1;
+    const int64_t startY = std::max<int64_t>(CeilDiv(std::min({ py[0], py[1], py[2] }), kSubPixelScale), 0);
+    const int64_t endY = std::min<int64_t>(FloorDiv(std::max({ py[0], py[1], py[2] }), kSubPixelScale), maxY);
+
+    TriangleRows rows(px, py, startY, frameBuffer->GetSampleOffsets(), 1);
+    for (int64_t y = startY; y <= endY; ++y)
+    {
+        int64_t startX, endX;
+        rows.NextRow(maxX, &startX, &endX);
+        if (startX <= endX)
         {
-            float t = static_cast<float>(y - startY) / dy;
-            Vertex aSide = LerpVertex(a, c, t);
-            Vertex bSide = LerpVertex(b, c, t);
-            DrawLine(aSide, bSide);
+            (this->*drawSpan)(setup, flatColor, static_cast<int>(y), static_cast<int>(startX), static_cast<int>(endX));
         }
     }
-    // if b and c are the same, flat bottom
-    else if (MathHelper::CheckEqual(b.pos.y, c.pos.y))
+}
+
+void Rasterizer::DrawMultisampleTriangle(const TriangleSetup& setup, const X::Color& flatColor, const int64_t px[3], const int64_t py[3])
+{
+    FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const int sampleCount = static_cast<int>(frameBuffer->GetSampleCount());
+    const FrameBuffer::SampleOffset* offsets = frameBuffer->GetSampleOffsets();
+    const int64_t maxX = static_cast<int64_t>(frameBuffer->GetWidth()) - 1;
+    const int64_t maxY = static_cast<int64_t>(frameBuffer->GetHeight()) - 1;
+    // Samples lie within half a pixel of the pixel's point
+    const int64_t halfPixel = kSubPixelScale / 2;
+    const int64_t startY = std::max<int64_t>(CeilDiv(std::min({ py[0], py[1], py[2] }) - halfPixel, kSubPixelScale), 0);
+    const int64_t endY = std::min<int64_t>(FloorDiv(std::max({ py[0], py[1], py[2] }) + halfPixel, kSubPixelScale), maxY);
+    if (startY > endY)
     {
-        int startY = static_cast<int>(a.pos.y);
-        int endY = static_cast<int>(c.pos.y);
+        return;
+    }
+
+    TriangleRows rows(px, py, startY, offsets, sampleCount);
+    // The frame buffer reads the coverage of 4 pixels at a time, so the row has 3 more past its end
+    if (mSampleCoverage.size() < static_cast<size_t>(maxX + 4))
+    {
+        mSampleCoverage.resize(static_cast<size_t>(maxX + 4));
+    }
+
+    const SpanKernel drawSpan = mSpanKernel;
+    const uint8_t allSamples = static_cast<uint8_t>((1 << sampleCount) - 1);
+    int64_t sampleStart[FrameBuffer::kMaxSampleCount];
+    int64_t sampleEnd[FrameBuffer::kMaxSampleCount];
+    // The same spans for 4 samples per SIMD compare, ends are one past the last pixel
+    alignas(16) int32_t laneStart[FrameBuffer::kMaxSampleCount];
+    alignas(16) int32_t laneEnd[FrameBuffer::kMaxSampleCount];
+    for (int64_t y = startY; y <= endY; ++y)
+    {
+        // The row reaches from the leftmost sample span start to the rightmost end, pixels inside every sample span are fully covered
+        int64_t left = maxX + 1;
+        int64_t right = -1;
+        int64_t innerLeft = 0;
+        int64_t innerRight = maxX;
+        rows.NextRow(maxX, sampleStart, sampleEnd);
+        for (int s = 0; s < sampleCount; ++s)
+        {
+            if (sampleStart[s] <= sampleEnd[s])
+            {
+                left = std::min(left, sampleStart[s]);
+                right = std::max(right, sampleEnd[s]);
+            }
+            innerLeft = std::max(innerLeft, sampleStart[s]);
+            innerRight = std::min(innerRight, sampleEnd[s]);
+        }
+        if (left > right)
+        {
+            continue;
+        }
+        if (innerLeft > innerRight)
+        {
+            innerLeft = right + 1;
+            innerRight = right;
+        }
 
-        for (int y = startY; y <= endY; ++y)
+        // Fully covered pixels take the single color path of the frame buffer, so only the partly covered ones cost per sample work
+        for (int s = 0; s < sampleCount; ++s)
+        {
+            laneStart[s] = static_cast<int32_t>(std::min(sampleStart[s], maxX + 1));
+            laneEnd[s] = static_cast<int32_t>(std::max(sampleEnd[s], int64_t(-1)) + 1);
+        }
+        auto setPartialMasks = [&](int64_t from, int64_t to)
         {
-            float t = static_cast<float>(y - startY) / dy;
-            Vertex bSide = LerpVertex(a, b, t);
-            Vertex cSide = LerpVertex(a, c, t);
-            DrawLine(bSide, cSide);
+            for (int64_t x = from; x <= to; ++x)
+            {
+                const __m128i pixelX = _mm_set1_epi32(static_cast<int>(x));
+                const __m128i nextX = _mm_set1_epi32(static_cast<int>(x + 1));
+                int mask = 0;
+                for (int s = 0; s < sampleCount; s += 4)
+                {
+                    const __m128i start = _mm_load_si128(reinterpret_cast<const __m128i*>(laneStart + s));
+                    const __m128i end = _mm_load_si128(reinterpret_cast<const __m128i*>(laneEnd + s));
+                    const __m128i inside = _mm_and_si128(_mm_cmplt_epi32(start, nextX), _mm_cmplt_epi32(pixelX, end));
+                    mask |= _mm_movemask_ps(_mm_castsi128_ps(inside)) << s;
+                }
+                mSampleCoverage[x - left] = static_cast<uint8_t>(mask);
+            }
+        };
+        setPartialMasks(left, innerLeft - 1);
+        std::fill(mSampleCoverage.data() + (innerLeft - left), mSampleCoverage.data() + (innerRight - left + 1), allSamples);
+        setPartialMasks(innerRight + 1, right);
+
+        frameBuffer->SetSampleCoverage(mSampleCoverage.data(), static_cast<int>(left));
+        (this->*drawSpan)(setup, flatColor, static_cast<int>(y), static_cast<int>(left), static_cast<int>(right));
+    }
+    frameBuffer->SetSampleCoverage(nullptr, 0);
+}
+
+bool Rasterizer::TrackDraw(float minX, float minY, float maxX, float maxY, uint64_t inputHash) const
+{
+    // Everything else the draw's pixels depend on, zeroed first so padding hashes the same every frame
+    struct State
+    {
+        float color[4];
+        const Texture* texture;
+        const Shader* shader;
+        float lineWidth;
+        uint32_t sampleCount;
+        FillMode fillMode;
+        TextureFilter textureFilter;
+        BlendMode blendMode;
+        ShadeMode shadeMode;
+        bool depthTest;
+        bool lineSmooth;
+    };
+    State state;
+    std::memset(&state, 0, sizeof(state));
+    state.color[0] = mColor.r;
+    state.color[1] = mColor.g;
+    state.color[2] = mColor.b;
+    state.color[3] = mColor.a;
+    state.texture = mTexture;
+    state.shader = mShader;
+    state.lineWidth = mLineWidth;
+    state.sampleCount = FrameBuffer::Get()->GetSampleCount();
+    state.fillMode = mFillMode;
+    state.textureFilter = mTextureFilter;
+    state.blendMode = mBlendMode;
+    state.shadeMode = mShadeMode;
+    state.depthTest = mDepthTest;
+    state.lineSmooth = mLineSmooth;
+    const uint64_t hash = FrameBuffer::HashInput(&state, sizeof(state), inputHash);
+
+    // Bounds grow by the reach of wide and anti-aliased edges, NaN and huge positions are pinned
+    const float margin = 1.0f + 0.5f * mLineWidth;
+    auto toPixel = [](float v)
+    {
+        constexpr float kLimit = 1 << 24;
+        return v > -kLimit ? (v < kLimit ? FloorToInt(v) : static_cast<int>(kLimit)) : -static_cast<int>(kLimit);
+    };
+    return FrameBuffer::Get()->AddTileInput(toPixel(minX - margin), toPixel(minY - margin), toPixel(maxX + margin) + 1, toPixel(maxY + margin) + 1, hash);
+}
+
+void Rasterizer::UpdateSpanKernel()
+{
+    // [depth test][blend mode][textured][gouraud]
+    constexpr int kBlendModeCount = static_cast<int>(BlendMode::Premultiplied) + 1;
+    static const SpanKernel sKernels[2][kBlendModeCount][2][2] =
+    {
+#define SPAN_KERNELS(depth, blend) \
+        { \
+            { &Rasterizer::DrawTriangleSpan<depth, blend, false, false>, &Rasterizer::DrawTriangleSpan<depth, blend, false, true> }, \
+            { &Rasterizer::DrawTriangleSpan<depth, blend, true, false>, &Rasterizer::DrawTriangleSpan<depth, blend, true, true> }, \
         }
+#define SPAN_KERNELS_BLEND(depth) \
+        { \
+            SPAN_KERNELS(depth, BlendMode::Opaque), \
+            SPAN_KERNELS(depth, BlendMode::Alpha), \
+            SPAN_KERNELS(depth, BlendMode::Additive), \
+            SPAN_KERNELS(depth, BlendMode::Multiply), \
+            SPAN_KERNELS(depth, BlendMode::Premultiplied), \
+        }
+        SPAN_KERNELS_BLEND(false),
+        SPAN_KERNELS_BLEND(true),
+#undef SPAN_KERNELS_BLEND
+#undef SPAN_KERNELS
+    };
+
+    // [depth test][blend mode]
+    static const SpanKernel sShadedKernels[2][kBlendModeCount] =
+    {
+#define SHADED_SPAN_KERNELS(depth) \
+        { \
+            &Rasterizer::DrawShadedSpan<depth, BlendMode::Opaque>, \
+            &Rasterizer::DrawShadedSpan<depth, BlendMode::Alpha>, \
+            &Rasterizer::DrawShadedSpan<depth, BlendMode::Additive>, \
+            &Rasterizer::DrawShadedSpan<depth, BlendMode::Multiply>, \
+            &Rasterizer::DrawShadedSpan<depth, BlendMode::Premultiplied>, \
+        }
+        SHADED_SPAN_KERNELS(false),
+        SHADED_SPAN_KERNELS(true),
+#undef SHADED_SPAN_KERNELS
+    };
+
+    if (mShader != nullptr)
+    {
+        mSpanKernel = sShadedKernels[mDepthTest][static_cast<int>(mBlendMode)];
+        return;
+    }
+    mSpanKernel = sKernels[mDepthTest][static_cast<int>(mBlendMode)][mTexture != nullptr][mShadeMode == ShadeMode::Gouraud];
+}
+
+template <bool DepthTest, BlendMode Blend, bool Textured, bool Gouraud>
+void Rasterizer::DrawTriangleSpan(const TriangleSetup& setup, const X::Color& flatColor, int y, int startX, int endX)
+{
+    using Attribute = TriangleSetup::Attribute;
+    FrameBuffer* frameBuffer = FrameBuffer::Get();
+
+    // Nothing varies across the span, it is a plain fill
+    if constexpr (!DepthTest && !Textured && !Gouraud)
+    {
+        const __m128i pixel = FrameBuffer::PackColors(_mm_set1_ps(flatColor.r), _mm_set1_ps(flatColor.g), _mm_set1_ps(flatColor.b), _mm_set1_ps(flatColor.a));
+        frameBuffer->FillSpan<Blend>(y, startX, endX, static_cast<uint32_t>(_mm_cvtsi128_si32(pixel)));
     }
-    // if none are equal, need to splot triangle
     else
     {
-        float t = (b.pos.y - a.pos.y) / dy;
-        Vertex splitVertex = LerpVertex(a, c, t);
-        // bottom fill
-        DrawFilledTriangle(a, b, splitVertex);
-        // top fill
-        DrawFilledTriangle(b, splitVertex, c);
+        // Attributes for 4 pixels in SIMD lanes, stepped by adding 4 * ddx. Only the ones this state reads.
+        constexpr bool perspective = Textured || Gouraud;
+        const __m128 laneOffset = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        __m128 value[TriangleSetup::Count];
+        __m128 step[TriangleSetup::Count];
+        auto setupAttribute = [&](Attribute attribute)
+        {
+            const __m128 ddx = _mm_set1_ps(setup.ddx[attribute]);
+            value[attribute] = _mm_add_ps(_mm_set1_ps(setup.ValueAt(attribute, static_cast<float>(startX), static_cast<float>(y))), _mm_mul_ps(ddx, laneOffset));
+            step[attribute] = _mm_mul_ps(ddx, _mm_set1_ps(4.0f));
+        };
+        auto stepAttribute = [&](Attribute attribute)
+        {
+            value[attribute] = _mm_add_ps(value[attribute], step[attribute]);
+        };
+
+        value[Attribute::Z] = _mm_setzero_ps();
+        if constexpr (DepthTest)
+        {
+            setupAttribute(Attribute::Z);
+        }
+        if constexpr (perspective)
+        {
+            setupAttribute(Attribute::InvW);
+        }
+        if constexpr (Gouraud)
+        {
+            setupAttribute(Attribute::R);
+            setupAttribute(Attribute::G);
+            setupAttribute(Attribute::B);
+            setupAttribute(Attribute::A);
+        }
+        if constexpr (Textured)
+        {
+            setupAttribute(Attribute::U);
+            setupAttribute(Attribute::V);
+        }
+
+        const __m128 flatR = _mm_set1_ps(flatColor.r);
+        const __m128 flatG = _mm_set1_ps(flatColor.g);
+        const __m128 flatB = _mm_set1_ps(flatColor.b);
+        const __m128 flatA = _mm_set1_ps(flatColor.a);
+        const __m128i flatPixel = FrameBuffer::PackColors(flatR, flatG, flatB, flatA);
+        for (int x = startX; x <= endX; x += 4)
+        {
+            __m128i pixels = flatPixel;
+            if constexpr (perspective)
+            {
+                // One reciprocal per pixel recovers the perspective correct attributes
+                const __m128 w = _mm_div_ps(_mm_set1_ps(1.0f), value[Attribute::InvW]);
+                __m128 colorR = flatR, colorG = flatG, colorB = flatB, colorA = flatA;
+                if constexpr (Gouraud)
+                {
+                    colorR = _mm_mul_ps(value[Attribute::R], w);
+                    colorG = _mm_mul_ps(value[Attribute::G], w);
+                    colorB = _mm_mul_ps(value[Attribute::B], w);
+                    colorA = _mm_mul_ps(value[Attribute::A], w);
+                }
+
+                if constexpr (Textured)
+                {
+                    const __m128 u = _mm_mul_ps(value[Attribute::U], w);
+                    const __m128 v = _mm_mul_ps(value[Attribute::V], w);
+
+                    // Lod from the UV derivatives of the first pixel, shared by the 4 pixels
+                    const float w0 = _mm_cvtss_f32(w);
+                    const float u0 = _mm_cvtss_f32(u);
+                    const float v0 = _mm_cvtss_f32(v);
+                    const float texWidth = static_cast<float>(mTexture->GetWidth());
+                    const float texHeight = static_cast<float>(mTexture->GetHeight());
+                    const float dudx = (setup.ddx[Attribute::U] - u0 * setup.ddx[Attribute::InvW]) * w0 * texWidth;
+                    const float dvdx = (setup.ddx[Attribute::V] - v0 * setup.ddx[Attribute::InvW]) * w0 * texHeight;
+                    const float dudy = (setup.ddy[Attribute::U] - u0 * setup.ddy[Attribute::InvW]) * w0 * texWidth;
+                    const float dvdy = (setup.ddy[Attribute::V] - v0 * setup.ddy[Attribute::InvW]) * w0 * texHeight;
+                    const float lod = mTexture->GetLod(dudx, dvdx, dudy, dvdy);
+
+                    __m128 texR, texG, texB, texA;
+                    mTexture->Sample(mTextureFilter, lod, u, v, texR, texG, texB, texA);
+                    colorR = _mm_mul_ps(colorR, texR);
+                    colorG = _mm_mul_ps(colorG, texG);
+                    colorB = _mm_mul_ps(colorB, texB);
+                    colorA = _mm_mul_ps(colorA, texA);
+                }
+
+                pixels = FrameBuffer::PackColors(colorR, colorG, colorB, colorA);
+            }
+
+            const int count = std::min(4, endX - x + 1);
+            frameBuffer->WritePixels<Blend, DepthTest>(x, y, kLaneMask[count], pixels, value[Attribute::Z]);
+
+            if constexpr (DepthTest)
+            {
+                stepAttribute(Attribute::Z);
+            }
+            if constexpr (perspective)
+            {
+                stepAttribute(Attribute::InvW);
+            }
+            if constexpr (Gouraud)
+            {
+                stepAttribute(Attribute::R);
+                stepAttribute(Attribute::G);
+                stepAttribute(Attribute::B);
+                stepAttribute(Attribute::A);
+            }
+            if constexpr (Textured)
+            {
+                stepAttribute(Attribute::U);
+                stepAttribute(Attribute::V);
+            }
+        }
     }
-}
\ No newline at end of file
+}
+
+template <bool DepthTest, BlendMode Blend>
+void Rasterizer::DrawShadedSpan(const TriangleSetup& setup, const X::Color& /*flatColor*/, int y, int startX, int endX)
+{
+    using Attribute = TriangleSetup::Attribute;
+
+    // Every attribute for 4 pixels in SIMD lanes, stepped by adding 4 * ddx
+    const __m128 laneOffset = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128 value[TriangleSetup::Count];
+    __m128 step[TriangleSetup::Count];
+    for (int i = 0; i < TriangleSetup::Count; ++i)
+    {
+        const Attribute attribute = static_cast<Attribute>(i);
+        const __m128 ddx = _mm_set1_ps(setup.ddx[i]);
+        value[i] = _mm_add_ps(_mm_set1_ps(setup.ValueAt(attribute, static_cast<float>(startX), static_cast<float>(y))), _mm_mul_ps(ddx, laneOffset));
+        step[i] = _mm_mul_ps(ddx, _mm_set1_ps(4.0f));
+    }
+
+    FrameBuffer* frameBuffer = FrameBuffer::Get();
+    const __m128 keepAll = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    PixelBatch batch;
+    batch.y = y;
+    batch.texture = mTexture;
+    batch.filter = mTextureFilter;
+    for (int batchX = startX; batchX <= endX; batchX += PixelBatch::kMaxCount)
+    {
+        // Perspective correct varyings for the whole run, then one call into the shader
+        batch.x = batchX;
+        batch.count = std::min(PixelBatch::kMaxCount, endX - batchX + 1);
+        for (int i = 0; i < batch.count; i += 4)
+        {
+            const __m128 w = _mm_div_ps(_mm_set1_ps(1.0f), value[Attribute::InvW]);
+            _mm_store_ps(batch.z + i, value[Attribute::Z]);
+            for (int varying = 0; varying < PixelBatch::VaryingCount; ++varying)
+            {
+                _mm_store_ps(batch.varyings[varying] + i, _mm_mul_ps(value[Attribute::R + varying], w));
+            }
+            _mm_store_ps(batch.keep + i, keepAll);
+
+            // Texture coordinate derivatives at the first pixel of the group
+            const float w0 = _mm_cvtss_f32(w);
+            const float u0 = batch.varyings[PixelBatch::U][i];
+            const float v0 = batch.varyings[PixelBatch::V][i];
+            float* derivatives = batch.uvDerivatives[i / 4];
+            derivatives[0] = (setup.ddx[Attribute::U] - u0 * setup.ddx[Attribute::InvW]) * w0;
+            derivatives[1] = (setup.ddx[Attribute::V] - v0 * setup.ddx[Attribute::InvW]) * w0;
+            derivatives[2] = (setup.ddy[Attribute::U] - u0 * setup.ddy[Attribute::InvW]) * w0;
+            derivatives[3] = (setup.ddy[Attribute::V] - v0 * setup.ddy[Attribute::InvW]) * w0;
+
+            for (int j = 0; j < TriangleSetup::Count; ++j)
+            {
+                value[j] = _mm_add_ps(value[j], step[j]);
+            }
+        }
+
+        mShader->ShadePixels(batch);
+
+        for (int i = 0; i < batch.count; i += 4)
+        {
+            const __m128i pixels = FrameBuffer::PackColors(
+                _mm_load_ps(batch.color[0] + i),
+                _mm_load_ps(batch.color[1] + i),
+                _mm_load_ps(batch.color[2] + i),
+                _mm_load_ps(batch.color[3] + i));
+            const int mask = kLaneMask[std::min(4, batch.count - i)] & _mm_movemask_ps(_mm_load_ps(batch.keep + i));
+            frameBuffer->WritePixels<Blend, DepthTest>(batchX + i, y, mask, pixels, _mm_load_ps(batch.z + i));
+        }
+    }
+}
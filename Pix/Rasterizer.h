@@ -1,31 +1,140 @@
 #pragma once
 
 #include <XEngine.h>
+#include "FrameBuffer.h"
+#include "Texture.h"
+#include "Vector2.h"
 #include "Vertex.h"
 
+#include <vector>
+
+class Shader;
+struct PreparedTriangle;
+struct TriangleSetup;
+
 enum class FillMode
 {
 	Wireframe,
 	Solid,
 };
 
+enum class ShadeMode
+{
+	// Whole triangle takes the color of its first vertex
+	Flat,
+	// Colors interpolated across the triangle
+	Gouraud,
+};
+
+// Which points a polygon with crossing or nested contours covers
+enum class FillRule
+{
+	// Inside where a ray crosses an odd number of edges, nested contours cut holes
+	EvenOdd,
+	// Inside where the edges wind around the point a non-zero number of times
+	NonZero,
+};
+
 class Rasterizer
 {
 public:
 	static Rasterizer* Get();
 
 public:
+	// Unbind the texture, so untextured Vertex() forms are parsed as before on the next frame,
+	// and put the rest of the render state back to its defaults
+	void OnNewFrame();
+
 	void SetColor(X::Color color);
 	void SetFillMode(FillMode fillmode);
+	// Texture for filled triangles, modulated by the vertex color. nullptr to disable.
+	void SetTexture(const Texture* texture);
+	void SetTextureFilter(TextureFilter filter);
+	// How drawn pixels combine with the frame buffer
+	void SetBlendMode(BlendMode mode);
+	void SetShadeMode(ShadeMode mode);
+	// Keep only triangle pixels nearer than what is already drawn
+	void SetDepthTest(bool enabled);
+	// Lines wider than a pixel, or smooth ones, are drawn with per pixel coverage
+	void SetLineWidth(float width);
+	void SetLineSmooth(bool enabled);
+	// Programmable vertex and pixel stages for triangles, nullptr for the fixed pipeline
+	void SetShader(const Shader* shader);
+	const Shader* GetShader() const { return mShader; }
+	const Texture* GetTexture() const { return mTexture; }
+	FillMode GetFillMode() const { return mFillMode; }
 
 	void DrawPoint(int x, int y);
 	void DrawPoint(const Vertex& vertex);
 	void DrawLine(const Vertex& a, const Vertex& b);
 	void DrawTriangle(const Vertex& a, const Vertex& b, const Vertex& c);
+	// Filled triangles split in two for meshes drawn again with the same vertex stage: the work that only depends on
+	// the vertices is done once, drawing the prepared triangle then tracks and rasterizes it like DrawTriangle.
+	// Only for solid fill, wireframe draws the edges from the vertices.
+	void PrepareTriangle(const Vertex& a, const Vertex& b, const Vertex& c, PreparedTriangle& prepared) const;
+	void DrawPreparedTriangle(const PreparedTriangle& prepared);
+	// Closed contours of one shape, contourEnds holds one past the last vertex of each.
+	// The shape is filled with the first vertex color as horizontal spans, every pixel written at most once.
+	void DrawPolygon(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& contourEnds, FillRule rule);
+	// Axis aligned ellipse around (x, y) in pixels, a circle when both radii match.
+	// The aliased form solves each row of the buffer for the pixels nearest the curve, the anti-aliased one takes coverage
+	// from the distance to the curve. Only rows and columns on the buffer are visited, non-finite values draw nothing.
+	void DrawEllipse(float x, float y, float radiusX, float radiusY, bool filled, bool antiAliased);
+	// Anti-aliased fill of closed contours in pixels with the current color, contourEnds as for DrawPolygon.
+	// Edges add signed area to a coverage buffer, a running sum along each row then gives every pixel's coverage.
+	void FillPath(const std::vector<Vector2>& points, const std::vector<uint32_t>& contourEnds, FillRule rule);
+	// Fill the region of matching pixels around (x, y) with the current color and blend mode
+	void FloodFill(int x, int y, float tolerance);
 
 private:
+	// Pixels startX to endX of row y, attributes stepped from the triangle's plane equations.
+	// One instantiation per render state combination, so the inner loop has no state branches.
+	template <bool DepthTest, BlendMode Blend, bool Textured, bool Gouraud>
+	void DrawTriangleSpan(const TriangleSetup& setup, const X::Color& flatColor, int y, int startX, int endX);
+	// Same for triangles drawn through the bound shader, which is called once per run of pixels
+	template <bool DepthTest, BlendMode Blend>
+	void DrawShadedSpan(const TriangleSetup& setup, const X::Color& flatColor, int y, int startX, int endX);
+	using SpanKernel = void (Rasterizer::*)(const TriangleSetup& setup, const X::Color& flatColor, int y, int startX, int endX);
+
+	// Hash the draw's inputs and the render state into the frame buffer tiles its pixel bounds reach.
+	// False when those are all kept from the last frame and the draw can be skipped.
+	bool TrackDraw(float minX, float minY, float maxX, float maxY, uint64_t inputHash) const;
+	// DrawLine once the draw is tracked, also for the edges of wireframe shapes
+	void RasterizeLine(const Vertex& a, const Vertex& b);
 	void DrawFilledTriangle(const Vertex& a, const Vertex& b, const Vertex& c);
+	// Snap to 28.4 fixed point with positive winding and set up the attribute planes, false when nothing can be covered
+	static bool SetupFilledTriangle(const Vertex& a, const Vertex& b, const Vertex& c, TriangleSetup& setup, int64_t px[3], int64_t py[3]);
+	// Rows of a triangle SetupFilledTriangle prepared
+	void RasterizeFilledTriangle(const TriangleSetup& setup, const X::Color& flatColor, const int64_t px[3], const int64_t py[3]);
+	// Triangle snapped to 28.4 fixed point with positive winding, coverage taken at every sample of the frame buffer.
+	// Fully covered pixels are drawn as ordinary spans, the partly covered ones at the ends of each row with their sample masks.
+	void DrawMultisampleTriangle(const TriangleSetup& setup, const X::Color& flatColor, const int64_t px[3], const int64_t py[3]);
+	void DrawFilledPolygon(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& contourEnds, FillRule rule);
+	void DrawMidpointEllipse(int x, int y, int radiusX, int radiusY, bool filled);
+	void DrawSmoothEllipse(float x, float y, float radiusX, float radiusY, bool filled);
+	// Row of path coverage from pixel left onwards, full runs as spans and edge pixels 4 at a time
+	template <BlendMode Mode>
+	void DrawCoverageRow(int y, int left, const float* coverage, int width);
+	// Edge pixel of an anti-aliased shape, coverage scales the color's alpha
+	void DrawCoveredPixel(int x, int y, const X::Color& color, float coverage);
+	// Line as a box of the line width, coverage of each pixel from its overlap with the box across and along the line
+	void DrawCoverageLine(const Vertex& a, const Vertex& b);
+	// Pick the span kernel for the current state, called whenever it changes
+	void UpdateSpanKernel();
 
 	X::Color mColor = X::Colors::White;
 	FillMode mFillMode = FillMode::Solid;
+	const Texture* mTexture = nullptr;
+	TextureFilter mTextureFilter = TextureFilter::Bilinear;
+	BlendMode mBlendMode = BlendMode::Opaque;
+	ShadeMode mShadeMode = ShadeMode::Gouraud;
+	bool mDepthTest = false;
+	float mLineWidth = 1.0f;
+	bool mLineSmooth = false;
+	const Shader* mShader = nullptr;
+	// Signed area and cover per pixel of the path being filled, reused between paths
+	std::vector<float> mCoverage;
+	// Sample masks of the partly covered pixels of a multisampled triangle row
+	std::vector<uint8_t> mSampleCoverage;
+	SpanKernel mSpanKernel = &Rasterizer::DrawTriangleSpan<false, BlendMode::Opaque, false, true>;
 };
\ No newline at end of file
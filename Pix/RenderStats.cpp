@@ -0,0 +1,67 @@
+#include "RenderStats.h"
+
+#include <ImGui/Inc/imgui.h>
+
+RenderStats* RenderStats::Get()
+{
+	static RenderStats sInstance;
+	return &sInstance;
+}
+
+void RenderStats::OnNewFrame()
+{
+	*this = {};
+}
+
+void RenderStats::ShowStats()
+{
+	ImGui::Begin("Stats", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+	ImGui::Text("Draw calls: %u", mDrawCalls);
+	ImGui::Text("Vertices submitted: %u", mVerticesSubmitted);
+	ImGui::Text("Vertices processed: %u", mVerticesProcessed);
+	ImGui::Text("Triangles: %u", mTriangles);
+
+	// Average cache miss ratio, i.e. vertices processed per triangle (3.0 = no reuse)
+	if (mTriangles > 0)
+		ImGui::Text("ACMR: %.3f", static_cast<float>(mVerticesProcessed) / static_cast<float>(mTriangles));
+	else
+		ImGui::Text("ACMR: -");
+
+	// Writes per covered pixel, a closed mesh drawn once should be exactly 1.0.
+	// Both only count tiles drawn this frame, kept tiles are neither written nor covered.
+	ImGui::Text("Pixels written: %u", mPixelsWritten);
+	ImGui::Text("Pixels covered: %u", mPixelsCovered);
+	if (mPixelsCovered > 0)
+		ImGui::Text("Overdraw: %.3f", static_cast<float>(mPixelsWritten) / static_cast<float>(mPixelsCovered));
+	else
+		ImGui::Text("Overdraw: -");
+
+	// Tiles not kept from the last frame, the ones whose pixels changed and were uploaded,
+	// and the ones a frame budget left for the next frames
+	ImGui::Text("Tiles drawn: %u / %u", mTilesDrawn, mTileCount);
+	ImGui::Text("Tiles uploaded: %u", mTilesUploaded);
+	ImGui::Text("Tiles pending: %u", mTilesPending);
+	ImGui::End();
+}
+
+void RenderStats::AddDraw(uint32_t verticesSubmitted, uint32_t verticesProcessed, uint32_t triangles)
+{
+	++mDrawCalls;
+	mVerticesSubmitted += verticesSubmitted;
+	mVerticesProcessed += verticesProcessed;
+	mTriangles += triangles;
+}
+
+void RenderStats::SetPixelStats(uint32_t pixelsWritten, uint32_t pixelsCovered)
+{
+	mPixelsWritten = pixelsWritten;
+	mPixelsCovered = pixelsCovered;
+}
+
+void RenderStats::SetTileStats(uint32_t tilesDrawn, uint32_t tilesUploaded, uint32_t tilesPending, uint32_t tileCount)
+{
+	mTilesDrawn = tilesDrawn;
+	mTilesUploaded = tilesUploaded;
+	mTilesPending = tilesPending;
+	mTileCount = tileCount;
+}
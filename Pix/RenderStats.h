@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+class RenderStats
+{
+public:
+	static RenderStats* Get();
+
+public:
+	void OnNewFrame();
+
+	void ShowStats();
+
+	void AddDraw(uint32_t verticesSubmitted, uint32_t verticesProcessed, uint32_t triangles);
+	void SetPixelStats(uint32_t pixelsWritten, uint32_t pixelsCovered);
+	void SetTileStats(uint32_t tilesDrawn, uint32_t tilesUploaded, uint32_t tilesPending, uint32_t tileCount);
+
+private:
+	uint32_t mDrawCalls = 0;
+	uint32_t mVerticesSubmitted = 0;
+	uint32_t mVerticesProcessed = 0;
+	uint32_t mTriangles = 0;
+	uint32_t mPixelsWritten = 0;
+	uint32_t mPixelsCovered = 0;
+	uint32_t mTilesDrawn = 0;
+	uint32_t mTilesUploaded = 0;
+	uint32_t mTilesPending = 0;
+	uint32_t mTileCount = 0;
+};
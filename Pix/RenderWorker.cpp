@@ -0,0 +1,142 @@
+#include "RenderWorker.h"
+
+#include "FrameBuffer.h"
+#include "Graphics.h"
+#include "ScriptParser.h"
+#include "VariableCache.h"
+
+#include <chrono>
+
+RenderWorker* RenderWorker::Get()
+{
+    static RenderWorker sInstance;
+    return &sInstance;
+}
+
+void RenderWorker::Start(ScriptParser& scriptParser)
+{
+    Stop();
+    mScriptParser = &scriptParser;
+    // The last frame rendered before stopping may never have been uploaded, so the first one goes up whole
+    mUploadAll = true;
+    mThread = std::thread(&RenderWorker::RenderLoop, this);
+}
+
+void RenderWorker::Stop()
+{
+    if (!mThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+    }
+    mFrontTaken.notify_one();
+    mThread.join();
+    mStopRequested = false;
+}
+
+void RenderWorker::SetDisplay(uint32_t pixelSize, bool showGrid)
+{
+    mPixelSize = pixelSize;
+    mShowGrid = showGrid;
+}
+
+void RenderWorker::PresentFrame()
+{
+    // A frame swapped in after the check is picked up next time, it cannot be replaced before it was uploaded
+    const bool frontNew = mFrontNew.load(std::memory_order_acquire);
+    Frame& front = mFrames[mFrontIndex.load(std::memory_order_acquire)];
+    if (front.width > 0 && front.height > 0)
+    {
+        if (frontNew)
+        {
+            X::InitRenderTexture(front.width, front.height, front.pixelSize);
+            X::DrawPixels(front.pixels.data(), front.width, front.height, front.changed.data(), static_cast<uint32_t>(front.changed.size()));
+        }
+        else
+        {
+            // The render texture still holds the front buffer, it only needs drawing again
+            X::DrawPixels(front.pixels.data(), front.width, front.height, nullptr, 0);
+        }
+        if (front.showGrid && front.pixelSize > 1)
+        {
+            X::DrawScreenGrid(front.pixelSize, X::Colors::DarkGray);
+        }
+    }
+    front.viewport.DrawViewport();
+
+    if (frontNew)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mFrontNew.store(false, std::memory_order_release);
+        }
+        mFrontTaken.notify_one();
+    }
+}
+
+void RenderWorker::ShowStats()
+{
+    Frame& front = mFrames[mFrontIndex.load(std::memory_order_acquire)];
+    front.stats.ShowStats();
+}
+
+float RenderWorker::GetFrameTime() const
+{
+    return mFrames[mFrontIndex.load(std::memory_order_acquire)].frameTime;
+}
+
+void RenderWorker::RenderLoop()
+{
+    while (!mStopRequested)
+    {
+        const auto startTime = std::chrono::steady_clock::now();
+        VariableCache::Get()->SyncWithEditor();
+        mShowGrid = false;
+
+        // More passes draw the tiles still due, kept ones whose draws changed after all or ones a frame budget spreads out
+        do
+        {
+            Graphics::NewFrame();
+            mScriptParser->ExecuteScript();
+        } while (!Graphics::EndFrame());
+        const std::chrono::duration<float, std::milli> frameTime = std::chrono::steady_clock::now() - startTime;
+
+        // The back buffer is the last front, free once the editor took the frame swapped in after it
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mFrontTaken.wait(lock, [this]() { return !mFrontNew.load(std::memory_order_acquire) || mStopRequested; });
+        }
+        if (mStopRequested)
+        {
+            break;
+        }
+
+        const uint32_t backIndex = 1 - mFrontIndex.load(std::memory_order_relaxed);
+        Frame& back = mFrames[backIndex];
+        const FrameBuffer* frameBuffer = FrameBuffer::Get();
+        back.pixels = frameBuffer->GetPresentPixels();
+        back.width = frameBuffer->GetWidth();
+        back.height = frameBuffer->GetHeight();
+        if (mUploadAll)
+        {
+            back.changed.assign(1, { 0, 0, back.width, back.height });
+            mUploadAll = false;
+        }
+        else
+        {
+            back.changed = frameBuffer->GetChangedRects();
+        }
+        back.pixelSize = mPixelSize;
+        back.showGrid = mShowGrid;
+        back.viewport = *Viewport::Get();
+        back.stats = *RenderStats::Get();
+        back.frameTime = frameTime.count();
+
+        mFrontIndex.store(backIndex, std::memory_order_release);
+        mFrontNew.store(true, std::memory_order_release);
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "RenderStats.h"
+#include "Viewport.h"
+
+#include <XEngine.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ScriptParser;
+
+// Runs the script and rasterizes on a thread of its own, so a slow scene does not hold up the editor.
+// Finished frames go to a back buffer that is swapped to the front once the editor took the last one,
+// the editor thread only ever uploads and draws the front buffer and never waits for a frame.
+class RenderWorker
+{
+public:
+    static RenderWorker* Get();
+
+public:
+    // Render the parsed script frame after frame until stopped, the script must not change in between
+    void Start(ScriptParser& scriptParser);
+    // Finish the frame in progress and join the thread, everything the script uses is then free to change
+    void Stop();
+
+    // Render thread, for the script: magnification and grid of the frames it draws
+    void SetDisplay(uint32_t pixelSize, bool showGrid);
+
+    // Editor thread: upload the newest finished frame if there is one and draw the front buffer
+    void PresentFrame();
+    void ShowStats();
+    // Milliseconds the front buffer took to render
+    float GetFrameTime() const;
+
+private:
+    struct Frame
+    {
+        std::vector<uint32_t> pixels;
+        std::vector<X::PixelRect> changed;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t pixelSize = 1;
+        bool showGrid = false;
+        Viewport viewport;
+        RenderStats stats;
+        float frameTime = 0.0f;
+    };
+
+    void RenderLoop();
+
+    ScriptParser* mScriptParser = nullptr;
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mFrontTaken;
+    std::atomic<bool> mStopRequested = false;
+
+    Frame mFrames[2];
+    std::atomic<uint32_t> mFrontIndex = 0;
+    // Set by the render thread once a frame is swapped to the front, cleared by the editor after uploading it
+    std::atomic<bool> mFrontNew = false;
+
+    uint32_t mPixelSize = 1;
+    bool mShowGrid = false;
+    bool mUploadAll = false;
+};
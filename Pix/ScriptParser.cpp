@@ -1,8 +1,10 @@
 #include "ScriptParser.h"
 
 #include "CommandDictionary.h"
+#include "MeshManager.h"
 
 #include <XEngine.h>
+#include <algorithm>
 #include <sstream>
 
 namespace
@@ -31,6 +33,36 @@ namespace
 
 		return tokens;
 	}
+
+	// Split a statement into keyword and parameters, quoted text is one parameter even with delimiters inside
+	auto TokenizeStatement(const std::string& line, const std::string& delimiters)
+	{
+		std::list<std::string> tokens;
+		std::size_t prev = 0;
+		while (prev < line.length())
+		{
+			if (line[prev] == '"')
+			{
+				const std::size_t end = line.find('"', prev + 1);
+				tokens.push_back(line.substr(prev + 1, end == std::string::npos ? std::string::npos : end - prev - 1));
+				prev = end == std::string::npos ? line.length() : end + 1;
+				continue;
+			}
+
+			const std::size_t pos = std::min(line.find_first_of(delimiters, prev), line.find('"', prev));
+			if (pos == std::string::npos)
+			{
+				tokens.push_back(line.substr(prev));
+				break;
+			}
+
+			if (pos > prev)
+				tokens.push_back(line.substr(prev, pos - prev));
+			prev = line[pos] == '"' ? pos : pos + 1;
+		}
+
+		return tokens;
+	}
 }
 
 // Parse script into commands and parameters
@@ -48,7 +80,7 @@ void ScriptParser::ParseScript(const std::string& script)
 		if (line.size() > 0 && line[0] == '/' && line[1] == '/')
 			continue;
 
-		auto tokens = TokenizeString(line, " ,()");
+		auto tokens = TokenizeStatement(line, " ,()");
 		if (tokens.empty())
 			continue;
 
@@ -68,8 +100,13 @@ void ScriptParser::ParseScript(const std::string& script)
 void ScriptParser::ExecuteScript()
 {
 	// Execute script commands
+	MeshManager* meshManager = MeshManager::Get();
 	for (auto& statement : mStatements)
 	{
+		// Skip the body of meshes that are already recorded
+		if (meshManager->IsSkipping() && statement.command != "EndMesh")
+			continue;
+
 		Command* command = CommandDictionary::Get()->CommandLookup(statement.command);
 		if (command == nullptr)
 		{
@@ -0,0 +1,480 @@
+#include "ShadeProgram.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+namespace
+{
+    constexpr int kGroupCount = ShadeProgram::kGroupCount;
+    constexpr float kPi = 3.14159265f;
+
+    __m128 Select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // SSE2 has no floor instruction, truncate and step down for negative values
+    __m128 Floor(__m128 x)
+    {
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+    }
+
+    // Reduce to [-pi/2, pi/2] then a 9th order polynomial, error below 1e-5
+    __m128 Sin(__m128 x)
+    {
+        const __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.5f / kPi))));
+        x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(2.0f * kPi)));
+        const __m128 pi = _mm_set1_ps(kPi);
+        const __m128 halfPi = _mm_set1_ps(0.5f * kPi);
+        x = Select(_mm_cmpgt_ps(x, halfPi), _mm_sub_ps(pi, x), x);
+        x = Select(_mm_cmplt_ps(x, _mm_sub_ps(_mm_setzero_ps(), halfPi)), _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), pi), x), x);
+
+        const __m128 x2 = _mm_mul_ps(x, x);
+        __m128 p = _mm_set1_ps(1.0f / 362880.0f);
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.0f / 5040.0f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 120.0f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.0f / 6.0f));
+        p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+        return _mm_mul_ps(p, x);
+    }
+
+    // Low 32 bits of a 32 bit multiply, SSE2 only multiplies the even lanes
+    __m128i Multiply32(__m128i a, __m128i b)
+    {
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    // Lattice point hash to 0-1
+    __m128 Hash(__m128i x, __m128i y)
+    {
+        __m128i h = _mm_add_epi32(Multiply32(x, _mm_set1_epi32(0x27d4eb2d)), Multiply32(y, _mm_set1_epi32(0x165667b1)));
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+        h = Multiply32(h, _mm_set1_epi32(0x2c1b3c6d));
+        h = _mm_xor_si128(h, _mm_srli_epi32(h, 12));
+        return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(h, 8)), _mm_set1_ps(1.0f / (1 << 24)));
+    }
+
+    // Value noise, hashed lattice values blended with a smoothstep
+    __m128 Noise(__m128 x, __m128 y)
+    {
+        const __m128 fx = Floor(x);
+        const __m128 fy = Floor(y);
+        const __m128 tx = _mm_sub_ps(x, fx);
+        const __m128 ty = _mm_sub_ps(y, fy);
+        const __m128i ix = _mm_cvttps_epi32(fx);
+        const __m128i iy = _mm_cvttps_epi32(fy);
+        const __m128i one = _mm_set1_epi32(1);
+
+        const __m128 h00 = Hash(ix, iy);
+        const __m128 h10 = Hash(_mm_add_epi32(ix, one), iy);
+        const __m128 h01 = Hash(ix, _mm_add_epi32(iy, one));
+        const __m128 h11 = Hash(_mm_add_epi32(ix, one), _mm_add_epi32(iy, one));
+
+        const __m128 three = _mm_set1_ps(3.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 sx = _mm_mul_ps(_mm_mul_ps(tx, tx), _mm_sub_ps(three, _mm_mul_ps(two, tx)));
+        const __m128 sy = _mm_mul_ps(_mm_mul_ps(ty, ty), _mm_sub_ps(three, _mm_mul_ps(two, ty)));
+        const __m128 top = _mm_add_ps(h00, _mm_mul_ps(_mm_sub_ps(h10, h00), sx));
+        const __m128 bottom = _mm_add_ps(h01, _mm_mul_ps(_mm_sub_ps(h11, h01), sx));
+        return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), sy));
+    }
+
+    // Iterations before |z| passes 2, over the iteration count, 4 points at once until all have escaped
+    __m128 Mandel(__m128 cx, __m128 cy, __m128 iterations)
+    {
+        const int maxIterations = std::clamp(static_cast<int>(_mm_cvtss_f32(iterations)), 1, 100000);
+        const __m128 four = _mm_set1_ps(4.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        __m128 zx = _mm_setzero_ps();
+        __m128 zy = _mm_setzero_ps();
+        __m128 count = _mm_setzero_ps();
+        __m128 active = _mm_cmpeq_ps(zx, zx);
+        for (int i = 0; i < maxIterations; ++i)
+        {
+            const __m128 zx2 = _mm_mul_ps(zx, zx);
+            const __m128 zy2 = _mm_mul_ps(zy, zy);
+            active = _mm_and_ps(active, _mm_cmple_ps(_mm_add_ps(zx2, zy2), four));
+            if (_mm_movemask_ps(active) == 0)
+            {
+                break;
+            }
+            count = _mm_add_ps(count, _mm_and_ps(active, one));
+            zy = _mm_add_ps(_mm_mul_ps(_mm_add_ps(zx, zx), zy), cy);
+            zx = _mm_add_ps(_mm_sub_ps(zx2, zy2), cx);
+        }
+        return _mm_mul_ps(count, _mm_set1_ps(1.0f / static_cast<float>(maxIterations)));
+    }
+
+    template <class F>
+    __m128* Unary(__m128* top, F f)
+    {
+        for (int i = 0; i < kGroupCount; ++i)
+        {
+            top[i] = f(top[i]);
+        }
+        return top;
+    }
+
+    template <class F>
+    __m128* Binary(__m128* top, F f)
+    {
+        __m128* a = top - kGroupCount;
+        for (int i = 0; i < kGroupCount; ++i)
+        {
+            a[i] = f(a[i], top[i]);
+        }
+        return a;
+    }
+
+    template <class F>
+    __m128* Ternary(__m128* top, F f)
+    {
+        __m128* a = top - 2 * kGroupCount;
+        __m128* b = top - kGroupCount;
+        for (int i = 0; i < kGroupCount; ++i)
+        {
+            a[i] = f(a[i], b[i], top[i]);
+        }
+        return a;
+    }
+}
+
+// Recursive descent over the expression, emitting instructions in evaluation order
+class ShadeProgram::Parser
+{
+public:
+    Parser(ShadeProgram& program, const std::string& text)
+        : mProgram(program)
+        , mText(text)
+    {
+    }
+
+    bool Parse(std::string& error)
+    {
+        const bool parsed = ParseSum() && (SkipSpaces(), mPosition == mText.size());
+        if (!parsed)
+        {
+            error = mError.empty() ? "unexpected '" + mText.substr(mPosition) + "'" : mError;
+        }
+        return parsed;
+    }
+
+private:
+    void SkipSpaces()
+    {
+        while (mPosition < mText.size() && std::isspace(static_cast<unsigned char>(mText[mPosition])))
+        {
+            ++mPosition;
+        }
+    }
+
+    bool Accept(char c)
+    {
+        SkipSpaces();
+        if (mPosition < mText.size() && mText[mPosition] == c)
+        {
+            ++mPosition;
+            return true;
+        }
+        return false;
+    }
+
+    void Emit(Op op, float value = 0.0f, int index = 0)
+    {
+        mProgram.mCode.push_back({ op, value, index });
+    }
+
+    void Push(Op op, float value = 0.0f, int index = 0)
+    {
+        Emit(op, value, index);
+        mProgram.mStackDepth = std::max(mProgram.mStackDepth, ++mDepth);
+    }
+
+    // sum := product (('+' | '-') product)*
+    bool ParseSum()
+    {
+        if (!ParseProduct())
+        {
+            return false;
+        }
+        while (true)
+        {
+            const Op op = Accept('+') ? Op::Add : (Accept('-') ? Op::Subtract : Op::PushConstant);
+            if (op == Op::PushConstant)
+            {
+                return true;
+            }
+            if (!ParseProduct())
+            {
+                return false;
+            }
+            Emit(op);
+            --mDepth;
+        }
+    }
+
+    // product := unary (('*' | '/' | '%') unary)*
+    bool ParseProduct()
+    {
+        if (!ParseUnary())
+        {
+            return false;
+        }
+        while (true)
+        {
+            const Op op = Accept('*') ? Op::Multiply : (Accept('/') ? Op::Divide : (Accept('%') ? Op::Modulo : Op::PushConstant));
+            if (op == Op::PushConstant)
+            {
+                return true;
+            }
+            if (!ParseUnary())
+            {
+                return false;
+            }
+            Emit(op);
+            --mDepth;
+        }
+    }
+
+    // unary := '-' unary | primary
+    bool ParseUnary()
+    {
+        if (Accept('-'))
+        {
+            if (!ParseUnary())
+            {
+                return false;
+            }
+            Emit(Op::Negate);
+            return true;
+        }
+        return ParsePrimary();
+    }
+
+    // primary := number | input | pi | $var | function '(' arguments ')' | '(' sum ')'
+    bool ParsePrimary()
+    {
+        SkipSpaces();
+        if (Accept('('))
+        {
+            return ParseSum() && Expect(')');
+        }
+        if (mPosition >= mText.size())
+        {
+            mError = "expression ends early";
+            return false;
+        }
+
+        const char c = mText[mPosition];
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.')
+        {
+            char* end = nullptr;
+            const float value = std::strtof(mText.c_str() + mPosition, &end);
+            mPosition = end - mText.c_str();
+            Push(Op::PushConstant, value);
+            return true;
+        }
+
+        const size_t start = mPosition;
+        while (mPosition < mText.size() && (std::isalnum(static_cast<unsigned char>(mText[mPosition])) || mText[mPosition] == '_' || mText[mPosition] == '$'))
+        {
+            ++mPosition;
+        }
+        const std::string name = mText.substr(start, mPosition - start);
+        if (name.empty())
+        {
+            return false;
+        }
+
+        if (name[0] == '$')
+        {
+            auto& names = mProgram.mUniformNames;
+            auto iter = std::find(names.begin(), names.end(), name);
+            const int index = static_cast<int>(iter - names.begin());
+            if (iter == names.end())
+            {
+                names.push_back(name);
+            }
+            Push(Op::PushUniform, 0.0f, index);
+            return true;
+        }
+
+        static const struct { const char* name; Input input; } kInputs[] = { { "x", X }, { "y", Y }, { "u", U }, { "v", V } };
+        for (const auto& input : kInputs)
+        {
+            if (name == input.name)
+            {
+                Push(Op::PushInput, 0.0f, input.input);
+                return true;
+            }
+        }
+        if (name == "pi")
+        {
+            Push(Op::PushConstant, kPi);
+            return true;
+        }
+
+        static const struct { const char* name; Op op; int arguments; } kFunctions[] =
+        {
+            { "sin", Op::Sin, 1 }, { "cos", Op::Cos, 1 }, { "sqrt", Op::Sqrt, 1 }, { "abs", Op::Abs, 1 },
+            { "floor", Op::Floor, 1 }, { "fract", Op::Fract, 1 }, { "min", Op::Min, 2 }, { "max", Op::Max, 2 },
+            { "step", Op::Step, 2 }, { "mix", Op::Mix, 3 }, { "clamp", Op::Clamp, 3 }, { "noise", Op::Noise, 2 },
+            { "mandel", Op::Mandel, 3 },
+        };
+        for (const auto& function : kFunctions)
+        {
+            if (name == function.name)
+            {
+                if (!Expect('('))
+                {
+                    return false;
+                }
+                for (int i = 0; i < function.arguments; ++i)
+                {
+                    if ((i > 0 && !Expect(',')) || !ParseSum())
+                    {
+                        return false;
+                    }
+                }
+                if (!Expect(')'))
+                {
+                    return false;
+                }
+                Emit(function.op);
+                mDepth -= function.arguments - 1;
+                return true;
+            }
+        }
+
+        mError = "unknown name '" + name + "'";
+        return false;
+    }
+
+    bool Expect(char c)
+    {
+        if (Accept(c))
+        {
+            return true;
+        }
+        if (mError.empty())
+        {
+            mError = std::string("expected '") + c + "'";
+        }
+        return false;
+    }
+
+    ShadeProgram& mProgram;
+    const std::string& mText;
+    std::string mError;
+    size_t mPosition = 0;
+    int mDepth = 0;
+};
+
+bool ShadeProgram::Compile(const std::string& expression, std::string& error)
+{
+    mCode.clear();
+    mUniformNames.clear();
+    mStackDepth = 0;
+
+    Parser parser(*this, expression);
+    if (!parser.Parse(error))
+    {
+        mCode.clear();
+        return false;
+    }
+    return true;
+}
+
+void ShadeProgram::Evaluate(const __m128 inputs[InputCount][kGroupCount], const float* uniforms, __m128* stack, __m128* result) const
+{
+    // top points at the slot on top of the stack, each slot holds kGroupCount values
+    __m128* top = stack - kGroupCount;
+    for (const Instruction& instruction : mCode)
+    {
+        switch (instruction.op)
+        {
+        case Op::PushConstant:
+        {
+            top += kGroupCount;
+            std::fill(top, top + kGroupCount, _mm_set1_ps(instruction.value));
+            break;
+        }
+        case Op::PushInput:
+        {
+            top += kGroupCount;
+            std::copy(inputs[instruction.index], inputs[instruction.index] + kGroupCount, top);
+            break;
+        }
+        case Op::PushUniform:
+        {
+            top += kGroupCount;
+            std::fill(top, top + kGroupCount, _mm_set1_ps(uniforms[instruction.index]));
+            break;
+        }
+        case Op::Add:
+            top = Binary(top, [](__m128 a, __m128 b) { return _mm_add_ps(a, b); });
+            break;
+        case Op::Subtract:
+            top = Binary(top, [](__m128 a, __m128 b) { return _mm_sub_ps(a, b); });
+            break;
+        case Op::Multiply:
+            top = Binary(top, [](__m128 a, __m128 b) { return _mm_mul_ps(a, b); });
+            break;
+        case Op::Divide:
+            top = Binary(top, [](__m128 a, __m128 b) { return _mm_div_ps(a, b); });
+            break;
+        case Op::Modulo:
+            top = Binary(top, [](__m128 a, __m128 b) { return _mm_sub_ps(a, _mm_mul_ps(b, Floor(_mm_div_ps(a, b)))); });
+            break;
+        case Op::Negate:
+            top = Unary(top, [](__m128 a) { return _mm_sub_ps(_mm_setzero_ps(), a); });
+            break;
+        case Op::Sin:
+            top = Unary(top, [](__m128 a) { return Sin(a); });
+            break;
+        case Op::Cos:
+            top = Unary(top, [](__m128 a) { return Sin(_mm_add_ps(a, _mm_set1_ps(0.5f * kPi))); });
+            break;
+        case Op::Sqrt:
+            top = Unary(top, [](__m128 a) { return _mm_sqrt_ps(_mm_max_ps(a, _mm_setzero_ps())); });
+            break;
+        case Op::Abs:
+            top = Unary(top, [](__m128 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); });
+            break;
+        case Op::Floor:
+            top = Unary(top, [](__m128 a) { return Floor(a); });
+            break;
+        case Op::Fract:
+            top = Unary(top, [](__m128 a) { return _mm_sub_ps(a, Floor(a)); });
+            break;
+        case Op::Min:
+            top = Binary(top, [](__m128 a, __m128 b) { return _mm_min_ps(a, b); });
+            break;
+        case Op::Max:
+            top = Binary(top, [](__m128 a, __m128 b) { return _mm_max_ps(a, b); });
+            break;
+        case Op::Step:
+            top = Binary(top, [](__m128 edge, __m128 x) { return _mm_and_ps(_mm_cmpge_ps(x, edge), _mm_set1_ps(1.0f)); });
+            break;
+        case Op::Mix:
+            top = Ternary(top, [](__m128 a, __m128 b, __m128 t) { return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)); });
+            break;
+        case Op::Clamp:
+            top = Ternary(top, [](__m128 x, __m128 lo, __m128 hi) { return _mm_min_ps(_mm_max_ps(x, lo), hi); });
+            break;
+        case Op::Noise:
+            top = Binary(top, [](__m128 x, __m128 y) { return Noise(x, y); });
+            break;
+        case Op::Mandel:
+            top = Ternary(top, [](__m128 x, __m128 y, __m128 iterations) { return Mandel(x, y, iterations); });
+            break;
+        default:
+            break;
+        }
+    }
+    std::copy(top, top + kGroupCount, result);
+}
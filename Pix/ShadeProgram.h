@@ -0,0 +1,80 @@
+#pragma once
+
+#include <emmintrin.h>
+#include <string>
+#include <vector>
+
+// An expression in x, y, u, v and $vars compiled to stack bytecode.
+// Every instruction runs over a whole batch of pixels, so the dispatch cost is shared by many SIMD lanes.
+//
+// Operators: + - * / % and parentheses. Constants: numbers and pi.
+// Functions: sin cos sqrt abs floor fract min max step(edge, x) mix(a, b, t) clamp(x, lo, hi)
+// noise(x, y) for value noise in 0-1, and mandel(x, y, iterations) for the fraction of iterations
+// the Mandelbrot orbit of x + iy stays bounded.
+class ShadeProgram
+{
+public:
+    // SIMD groups of 4 pixels evaluated per instruction
+    static constexpr int kGroupCount = 16;
+    static constexpr int kBatchSize = kGroupCount * 4;
+
+    enum Input
+    {
+        X,
+        Y,
+        U,
+        V,
+        InputCount
+    };
+
+    // Returns false with a message in error if the expression does not parse
+    bool Compile(const std::string& expression, std::string& error);
+
+    // $vars the expression reads, uniforms passed to Evaluate follow this order
+    const std::vector<std::string>& GetUniformNames() const { return mUniformNames; }
+    // Stack slots of kGroupCount values that Evaluate needs as scratch
+    int GetStackDepth() const { return mStackDepth; }
+
+    // Evaluate one batch, inputs holds kGroupCount values per Input
+    void Evaluate(const __m128 inputs[InputCount][kGroupCount], const float* uniforms, __m128* stack, __m128* result) const;
+
+private:
+    enum class Op
+    {
+        PushConstant,
+        PushInput,
+        PushUniform,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Modulo,
+        Negate,
+        Sin,
+        Cos,
+        Sqrt,
+        Abs,
+        Floor,
+        Fract,
+        Min,
+        Max,
+        Step,
+        Mix,
+        Clamp,
+        Noise,
+        Mandel,
+    };
+
+    struct Instruction
+    {
+        Op op;
+        float value = 0.0f;
+        int index = 0;
+    };
+
+    class Parser;
+
+    std::vector<Instruction> mCode;
+    std::vector<std::string> mUniformNames;
+    int mStackDepth = 0;
+};
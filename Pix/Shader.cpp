@@ -0,0 +1,72 @@
+#include "Shader.h"
+
+#include <algorithm>
+#include <cstring>
+
+float PixelBatch::GetLod(const Texture& texture, int i) const
+{
+    const float* d = uvDerivatives[i / 4];
+    const float width = static_cast<float>(texture.GetWidth());
+    const float height = static_cast<float>(texture.GetHeight());
+    return texture.GetLod(d[0] * width, d[1] * height, d[2] * width, d[3] * height);
+}
+
+void Shader::ShadeVertices(const VertexStream& input, VertexStream& output, const X::Math::Matrix4& transform) const
+{
+    TransformPositions(input, output, transform);
+    CopyAttributes(input, output);
+}
+
+void Shader::TransformPositions(const VertexStream& input, VertexStream& output, const X::Math::Matrix4& m)
+{
+    using Attribute = VertexStream::Attribute;
+
+    const float* x = input.Data(Attribute::PosX);
+    const float* y = input.Data(Attribute::PosY);
+    const float* z = input.Data(Attribute::PosZ);
+    float* outX = output.Data(Attribute::PosX);
+    float* outY = output.Data(Attribute::PosY);
+    float* outZ = output.Data(Attribute::PosZ);
+    float* outW = output.Data(Attribute::PosW);
+
+    const __m128 m11 = _mm_set1_ps(m._11), m12 = _mm_set1_ps(m._12), m13 = _mm_set1_ps(m._13), m14 = _mm_set1_ps(m._14);
+    const __m128 m21 = _mm_set1_ps(m._21), m22 = _mm_set1_ps(m._22), m23 = _mm_set1_ps(m._23), m24 = _mm_set1_ps(m._24);
+    const __m128 m31 = _mm_set1_ps(m._31), m32 = _mm_set1_ps(m._32), m33 = _mm_set1_ps(m._33), m34 = _mm_set1_ps(m._34);
+    const __m128 m41 = _mm_set1_ps(m._41), m42 = _mm_set1_ps(m._42), m43 = _mm_set1_ps(m._43), m44 = _mm_set1_ps(m._44);
+
+    const uint32_t count = input.PaddedSize();
+    for (uint32_t i = 0; i < count; i += VertexStream::kLaneWidth)
+    {
+        const __m128 vx = _mm_load_ps(x + i);
+        const __m128 vy = _mm_load_ps(y + i);
+        const __m128 vz = _mm_load_ps(z + i);
+        _mm_store_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m11), _mm_mul_ps(vy, m21)), _mm_add_ps(_mm_mul_ps(vz, m31), m41)));
+        _mm_store_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m12), _mm_mul_ps(vy, m22)), _mm_add_ps(_mm_mul_ps(vz, m32), m42)));
+        _mm_store_ps(outZ + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m13), _mm_mul_ps(vy, m23)), _mm_add_ps(_mm_mul_ps(vz, m33), m43)));
+        _mm_store_ps(outW + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, m14), _mm_mul_ps(vy, m24)), _mm_add_ps(_mm_mul_ps(vz, m34), m44)));
+    }
+}
+
+void Shader::CopyAttributes(const VertexStream& input, VertexStream& output)
+{
+    using Attribute = VertexStream::Attribute;
+
+    const uint32_t count = input.PaddedSize();
+    for (Attribute attribute : { Attribute::TexU, Attribute::TexV })
+    {
+        std::memcpy(output.Data(attribute), input.Data(attribute), count * sizeof(float));
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (Attribute attribute : { Attribute::ColorR, Attribute::ColorG, Attribute::ColorB, Attribute::ColorA })
+    {
+        const float* src = input.Data(attribute);
+        float* dst = output.Data(attribute);
+        for (uint32_t i = 0; i < count; i += VertexStream::kLaneWidth)
+        {
+            const __m128 c = _mm_load_ps(src + i);
+            _mm_store_ps(dst + i, _mm_min_ps(_mm_max_ps(c, zero), one));
+        }
+    }
+}
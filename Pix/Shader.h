@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Texture.h"
+#include "VertexStream.h"
+
+#include <XMath.h>
+#include <emmintrin.h>
+
+// A run of pixels of one triangle row, handed to the pixel function all at once.
+// Inputs are perspective corrected, lane i is pixel x + i. Arrays are padded to whole groups of 4.
+struct PixelBatch
+{
+    // Interpolated per pixel, written as color and texture coordinates by the vertex function
+    enum Varying
+    {
+        R,
+        G,
+        B,
+        A,
+        U,
+        V,
+        VaryingCount
+    };
+
+    static constexpr int kMaxCount = 64;
+
+    int x = 0;
+    int y = 0;
+    int count = 0;
+
+    // Texture bound to the rasterizer, nullptr if none
+    const Texture* texture = nullptr;
+    TextureFilter filter = TextureFilter::Bilinear;
+
+    alignas(16) float z[kMaxCount];
+    alignas(16) float varyings[VaryingCount][kMaxCount];
+    // Screen space derivatives of u and v for each group of 4 pixels: du/dx, dv/dx, du/dy, dv/dy
+    alignas(16) float uvDerivatives[kMaxCount / 4][4];
+
+    // Outputs, colors in 0-1 and a lane mask where all bits clear discards the pixel
+    alignas(16) float color[4][kMaxCount];
+    alignas(16) float keep[kMaxCount];
+
+    // Mip level for sampling a texture at pixel i, from the derivatives of its group
+    float GetLod(const Texture& texture, int i) const;
+};
+
+// Programmable stages for the rasterizer. Shaders work on whole batches so the
+// rasterizer makes one call per draw for vertices and one per pixel run for pixels.
+// Register new shaders with the ShaderLibrary to make them selectable from scripts.
+class Shader
+{
+public:
+    virtual ~Shader() = default;
+
+    virtual const char* GetName() const = 0;
+
+    // Map the input vertices to clip positions in PosX-PosW plus varyings in the color and texture slots.
+    // transform is the current world/view/projection. The default transforms and passes attributes through.
+    virtual void ShadeVertices(const VertexStream& input, VertexStream& output, const X::Math::Matrix4& transform) const;
+
+    // Fill the color of every pixel of the batch, and clear keep for the ones to discard
+    virtual void ShadePixels(PixelBatch& batch) const = 0;
+
+    // Building blocks for vertex functions, 4 vertices per SIMD lane over the padded stream
+    static void TransformPositions(const VertexStream& input, VertexStream& output, const X::Math::Matrix4& transform);
+    // Texture coordinates as is and colors saturated to 0-1
+    static void CopyAttributes(const VertexStream& input, VertexStream& output);
+};
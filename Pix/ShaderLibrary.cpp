@@ -0,0 +1,35 @@
+#include "ShaderLibrary.h"
+
+#include "GouraudShader.h"
+#include "TexturedShader.h"
+
+ShaderLibrary* ShaderLibrary::Get()
+{
+    static ShaderLibrary sInstance;
+    return &sInstance;
+}
+
+ShaderLibrary::ShaderLibrary()
+{
+    // Built in shaders, custom ones are registered here too
+    RegisterShader<GouraudShader>();
+    RegisterShader<TexturedShader>();
+}
+
+const Shader* ShaderLibrary::ShaderLookup(const std::string& name) const
+{
+    auto iter = mShaderMap.find(name);
+    if (iter == mShaderMap.end())
+    {
+        return nullptr;
+    }
+    return iter->second.get();
+}
+
+template <class T>
+void ShaderLibrary::RegisterShader()
+{
+    static_assert(std::is_base_of_v<Shader, T>, "Invalid shader type.");
+    auto newShader = std::make_unique<T>();
+    mShaderMap.emplace(newShader->GetName(), std::move(newShader));
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+// Every shader selectable with SetShader, by name
+class ShaderLibrary
+{
+public:
+    static ShaderLibrary* Get();
+
+public:
+    ShaderLibrary();
+
+    // nullptr if no shader has that name
+    const Shader* ShaderLookup(const std::string& name) const;
+
+private:
+    template <class T>
+    void RegisterShader();
+
+    std::map<std::string, std::unique_ptr<Shader>> mShaderMap;
+};
@@ -0,0 +1,55 @@
+#include "SurfaceLayout.h"
+
+namespace
+{
+    uint32_t NextPowerOfTwo(uint32_t v)
+    {
+        uint32_t result = 1;
+        while (result < v)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    uint32_t Log2(uint32_t powerOfTwo)
+    {
+        uint32_t bits = 0;
+        while ((1u << bits) < powerOfTwo)
+        {
+            ++bits;
+        }
+        return bits;
+    }
+}
+
+SurfaceLayout::SurfaceLayout(MemoryLayout layout, uint32_t width, uint32_t height)
+    : mLayout(layout)
+    , mWidth(width)
+    , mHeight(height)
+{
+    switch (layout)
+    {
+    case MemoryLayout::Tiled4x4:
+    case MemoryLayout::Tiled8x8:
+    {
+        const uint32_t tileSize = layout == MemoryLayout::Tiled4x4 ? 4 : 8;
+        mTilesPerRow = (width + tileSize - 1) / tileSize;
+        const uint32_t tileRows = (height + tileSize - 1) / tileSize;
+        mSize = mTilesPerRow * tileRows * tileSize * tileSize;
+    }
+    break;
+    case MemoryLayout::Morton:
+    {
+        const uint32_t paddedWidth = NextPowerOfTwo(width);
+        const uint32_t paddedHeight = NextPowerOfTwo(height);
+        mMortonBits = Log2(paddedWidth < paddedHeight ? paddedWidth : paddedHeight);
+        mMortonMask = (1u << mMortonBits) - 1;
+        mSize = paddedWidth * paddedHeight;
+    }
+    break;
+    default:
+        mSize = width * height;
+        break;
+    }
+}
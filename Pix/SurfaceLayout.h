@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <emmintrin.h>
+
+enum class MemoryLayout
+{
+    // Row after row
+    Linear,
+    // 4x4 or 8x8 blocks stored one after another, rows inside a block
+    Tiled4x4,
+    Tiled8x8,
+    // Z-order, x and y bits interleaved so 2D neighbours stay close in memory
+    Morton,
+};
+
+// Maps 2D coordinates to an element index for a given memory layout.
+// Sizes are padded up to whole tiles, or powers of two for Morton.
+class SurfaceLayout
+{
+public:
+    SurfaceLayout() = default;
+    SurfaceLayout(MemoryLayout layout, uint32_t width, uint32_t height);
+
+    MemoryLayout GetLayout() const { return mLayout; }
+    uint32_t GetWidth() const { return mWidth; }
+    uint32_t GetHeight() const { return mHeight; }
+    // Element count including padding
+    uint32_t GetSize() const { return mSize; }
+
+    uint32_t GetIndex(uint32_t x, uint32_t y) const
+    {
+        switch (mLayout)
+        {
+        case MemoryLayout::Tiled4x4:
+            return (((y >> 2) * mTilesPerRow + (x >> 2)) << 4) | ((y & 3) << 2) | (x & 3);
+        case MemoryLayout::Tiled8x8:
+            return (((y >> 3) * mTilesPerRow + (x >> 3)) << 6) | ((y & 7) << 3) | (x & 7);
+        case MemoryLayout::Morton:
+        {
+            // Interleave the bits both sides have, the longer side's extra bits go on top
+            const uint32_t low = Spread(x & mMortonMask) | (Spread(y & mMortonMask) << 1);
+            return low | (((x | y) >> mMortonBits) << (mMortonBits * 2));
+        }
+        default:
+            return y * mWidth + x;
+        }
+    }
+
+    // GetIndex for 4 coordinates at once, one per SIMD lane
+    __m128i GetIndex4(__m128i x, __m128i y) const
+    {
+        switch (mLayout)
+        {
+        case MemoryLayout::Tiled4x4:
+            return GetTiledIndex4(x, y, 2);
+        case MemoryLayout::Tiled8x8:
+            return GetTiledIndex4(x, y, 3);
+        case MemoryLayout::Morton:
+        {
+            const __m128i mask = _mm_set1_epi32(static_cast<int>(mMortonMask));
+            const __m128i low = _mm_or_si128(Spread4(_mm_and_si128(x, mask)), _mm_slli_epi32(Spread4(_mm_and_si128(y, mask)), 1));
+            const __m128i high = _mm_srl_epi32(_mm_or_si128(x, y), _mm_cvtsi32_si128(static_cast<int>(mMortonBits)));
+            return _mm_or_si128(low, _mm_sll_epi32(high, _mm_cvtsi32_si128(static_cast<int>(mMortonBits * 2))));
+        }
+        default:
+            // SSE2 has no 32 bit multiply, go through float which is exact below 2^24
+            return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(y), _mm_set1_ps(static_cast<float>(mWidth))), _mm_cvtepi32_ps(x)));
+        }
+    }
+
+private:
+    // Insert a zero bit between each of the low 16 bits
+    static uint32_t Spread(uint32_t v)
+    {
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+
+    static __m128i Spread4(__m128i v)
+    {
+        v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 8)), _mm_set1_epi32(0x00ff00ff));
+        v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 4)), _mm_set1_epi32(0x0f0f0f0f));
+        v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 2)), _mm_set1_epi32(0x33333333));
+        v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 1)), _mm_set1_epi32(0x55555555));
+        return v;
+    }
+
+    __m128i GetTiledIndex4(__m128i x, __m128i y, int tileBits) const
+    {
+        const __m128i shift = _mm_cvtsi32_si128(tileBits);
+        const __m128i mask = _mm_set1_epi32((1 << tileBits) - 1);
+        const __m128 tileX = _mm_cvtepi32_ps(_mm_srl_epi32(x, shift));
+        const __m128 tileY = _mm_cvtepi32_ps(_mm_srl_epi32(y, shift));
+        const __m128i tile = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(tileY, _mm_set1_ps(static_cast<float>(mTilesPerRow))), tileX));
+        const __m128i inTile = _mm_or_si128(_mm_sll_epi32(_mm_and_si128(y, mask), shift), _mm_and_si128(x, mask));
+        return _mm_or_si128(_mm_sll_epi32(tile, _mm_cvtsi32_si128(tileBits * 2)), inTile);
+    }
+
+    MemoryLayout mLayout = MemoryLayout::Linear;
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+    uint32_t mSize = 0;
+    uint32_t mTilesPerRow = 0;
+    uint32_t mMortonBits = 0;
+    uint32_t mMortonMask = 0;
+};
@@ -0,0 +1,336 @@
+#include "Texture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    template <class T>
+    T ReadAt(const std::vector<uint8_t>& data, size_t offset)
+    {
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            value |= static_cast<T>(data[offset + i]) << (8 * i);
+        }
+        return value;
+    }
+
+    // log2 from the float exponent and a linear mantissa, within 0.09 which is plenty for mip selection
+    float FastLog2(float x)
+    {
+        int32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        return static_cast<float>(bits) * (1.0f / (1 << 23)) - 127.0f;
+    }
+
+    // SSE2 has no floor instruction, truncate and step down for negative values
+    __m128 Floor(__m128 x)
+    {
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+    }
+
+    // Wrap texture coordinates to [0, 1)
+    __m128 Wrap(__m128 x)
+    {
+        return _mm_sub_ps(x, Floor(x));
+    }
+
+    // Clamp texel coordinates to [0, max], also maps NaN to 0 so the fetch stays in bounds
+    __m128 ClampTexel(__m128 x, __m128 max)
+    {
+        return _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), max);
+    }
+
+    // Fetch 4 texels, there is no gather in SSE2
+    __m128i Fetch(const uint32_t* texels, const SurfaceLayout& layout, __m128 x, __m128 y)
+    {
+        alignas(16) int32_t index[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(index), layout.GetIndex4(_mm_cvttps_epi32(x), _mm_cvttps_epi32(y)));
+        return _mm_setr_epi32(texels[index[0]], texels[index[1]], texels[index[2]], texels[index[3]]);
+    }
+
+    // Split 4 packed RGBA8 texels into one float register per channel, still in 0-255
+    void Unpack(__m128i texels, __m128& r, __m128& g, __m128& b, __m128& a)
+    {
+        const __m128i mask = _mm_set1_epi32(0xff);
+        r = _mm_cvtepi32_ps(_mm_and_si128(texels, mask));
+        g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 8), mask));
+        b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 16), mask));
+        a = _mm_cvtepi32_ps(_mm_srli_epi32(texels, 24));
+    }
+
+    __m128 Lerp(__m128 a, __m128 b, __m128 t)
+    {
+        return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+    }
+}
+
+bool Texture::Load(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // File header (14 bytes) followed by at least a BITMAPINFOHEADER (40 bytes)
+    if (data.size() < 54 || data[0] != 'B' || data[1] != 'M')
+    {
+        return false;
+    }
+
+    const uint32_t pixelOffset = ReadAt<uint32_t>(data, 10);
+    const int32_t width = static_cast<int32_t>(ReadAt<uint32_t>(data, 18));
+    const int32_t height = static_cast<int32_t>(ReadAt<uint32_t>(data, 22));
+    const uint16_t bitsPerPixel = ReadAt<uint16_t>(data, 28);
+    const uint32_t compression = ReadAt<uint32_t>(data, 30);
+
+    // Only uncompressed BGR/BGRA, 3 = bitfields which is plain BGRA for 32 bit files
+    const bool supported =
+        (bitsPerPixel == 24 && compression == 0) ||
+        (bitsPerPixel == 32 && (compression == 0 || compression == 3));
+    if (!supported || width <= 0 || height == 0)
+    {
+        return false;
+    }
+
+    // Rows are padded to 4 bytes, positive height means the bottom row comes first
+    const uint32_t w = static_cast<uint32_t>(width);
+    const uint32_t h = static_cast<uint32_t>(height > 0 ? height : -height);
+    const uint32_t bytesPerPixel = bitsPerPixel / 8;
+    const uint32_t rowStride = (w * bytesPerPixel + 3) & ~3u;
+    if (data.size() < pixelOffset + static_cast<size_t>(rowStride) * h)
+    {
+        return false;
+    }
+
+    mTexels.clear();
+    mTexels.resize(static_cast<size_t>(w) * h);
+    bool hasAlpha = false;
+    for (uint32_t y = 0; y < h; ++y)
+    {
+        const uint32_t srcRow = height > 0 ? h - 1 - y : y;
+        const uint8_t* src = data.data() + pixelOffset + static_cast<size_t>(srcRow) * rowStride;
+        uint32_t* dst = mTexels.data() + static_cast<size_t>(y) * w;
+        for (uint32_t x = 0; x < w; ++x, src += bytesPerPixel)
+        {
+            const uint32_t alpha = bytesPerPixel == 4 ? src[3] : 0xff;
+            hasAlpha |= alpha != 0;
+            dst[x] = src[2] | (src[1] << 8) | (src[0] << 16) | (alpha << 24);
+        }
+    }
+
+    // Many 32 bit files leave alpha at 0, treat those as opaque
+    if (!hasAlpha)
+    {
+        for (uint32_t& texel : mTexels)
+        {
+            texel |= 0xff000000;
+        }
+    }
+
+    mLevels.clear();
+    mLevels.push_back({ 0, w, h, SurfaceLayout(MemoryLayout::Linear, w, h) });
+    BuildMipChain();
+    return true;
+}
+
+void Texture::SetLayout(MemoryLayout layout)
+{
+    if (mLevels.empty() || layout == GetLayout())
+    {
+        return;
+    }
+
+    // Copy every level texel by texel into its new position
+    std::vector<uint32_t> texels;
+    std::vector<MipLevel> levels;
+    for (const MipLevel& src : mLevels)
+    {
+        MipLevel dst = { static_cast<uint32_t>(texels.size()), src.width, src.height, SurfaceLayout(layout, src.width, src.height) };
+        texels.resize(texels.size() + dst.layout.GetSize());
+        for (uint32_t y = 0; y < src.height; ++y)
+        {
+            for (uint32_t x = 0; x < src.width; ++x)
+            {
+                texels[dst.offset + dst.layout.GetIndex(x, y)] = mTexels[src.offset + src.layout.GetIndex(x, y)];
+            }
+        }
+        levels.push_back(dst);
+    }
+
+    mTexels = std::move(texels);
+    mLevels = std::move(levels);
+}
+
+void Texture::BuildMipChain()
+{
+    // Levels are built linear, Load always starts from a linear base.
+    // Reserve the whole chain up front, it is at most a third of the base level
+    mTexels.reserve(mTexels.size() + mTexels.size() / 3 + 32);
+
+    while (mLevels.back().width > 1 || mLevels.back().height > 1)
+    {
+        const MipLevel src = mLevels.back();
+        MipLevel dst;
+        dst.offset = static_cast<uint32_t>(mTexels.size());
+        dst.width = src.width > 1 ? src.width / 2 : 1;
+        dst.height = src.height > 1 ? src.height / 2 : 1;
+        dst.layout = SurfaceLayout(MemoryLayout::Linear, dst.width, dst.height);
+        mTexels.resize(mTexels.size() + static_cast<size_t>(dst.width) * dst.height);
+
+        // Average 2x2 texels. Odd sizes fold the last row/column into the texels before it, which then average
+        // 3x2, 2x3 or 3x3, so every source texel counts. A side of 1 stays 1 and averages that texel alone.
+        auto footprint = [](uint32_t i, uint32_t srcSize, uint32_t dstSize, uint32_t& first, uint32_t& count)
+        {
+            first = std::min(i * 2, srcSize - 1);
+            count = srcSize == 1 ? 1 : (i + 1 == dstSize && (srcSize & 1) != 0 ? 3 : 2);
+        };
+        const uint32_t* srcTexels = mTexels.data() + src.offset;
+        uint32_t* dstTexels = mTexels.data() + dst.offset;
+        for (uint32_t y = 0; y < dst.height; ++y)
+        {
+            uint32_t y0, rows;
+            footprint(y, src.height, dst.height, y0, rows);
+            for (uint32_t x = 0; x < dst.width; ++x)
+            {
+                uint32_t x0, columns;
+                footprint(x, src.width, dst.width, x0, columns);
+                uint32_t sum[4] = {};
+                for (uint32_t sy = y0; sy < y0 + rows; ++sy)
+                {
+                    const uint32_t* row = srcTexels + static_cast<size_t>(sy) * src.width;
+                    for (uint32_t sx = x0; sx < x0 + columns; ++sx)
+                    {
+                        for (uint32_t c = 0; c < 4; ++c)
+                        {
+                            sum[c] += (row[sx] >> (c * 8)) & 0xff;
+                        }
+                    }
+                }
+                const uint32_t count = rows * columns;
+                uint32_t texel = 0;
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    texel |= ((sum[c] + count / 2) / count) << (c * 8);
+                }
+                dstTexels[static_cast<size_t>(y) * dst.width + x] = texel;
+            }
+        }
+        mLevels.push_back(dst);
+    }
+}
+
+float Texture::GetLod(float dudx, float dvdx, float dudy, float dvdy) const
+{
+    const float rho2 = std::max(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+    return 0.5f * FastLog2(rho2);
+}
+
+void Texture::Sample(TextureFilter filter, float lod, __m128 u, __m128 v, __m128& r, __m128& g, __m128& b, __m128& a) const
+{
+    // Written so a NaN lod also ends up on the base level
+    const float maxLod = static_cast<float>(mLevels.size() - 1);
+    lod = lod > 0.0f ? std::min(lod, maxLod) : 0.0f;
+
+    if (filter == TextureFilter::Trilinear)
+    {
+        // Blend the two closest levels
+        const uint32_t level0 = static_cast<uint32_t>(lod);
+        const uint32_t level1 = std::min(level0 + 1, static_cast<uint32_t>(mLevels.size() - 1));
+        SampleBilinear(mLevels[level0], u, v, r, g, b, a);
+
+        const float t = lod - static_cast<float>(level0);
+        if (level1 != level0 && t > 0.0f)
+        {
+            __m128 r1, g1, b1, a1;
+            SampleBilinear(mLevels[level1], u, v, r1, g1, b1, a1);
+            const __m128 vt = _mm_set1_ps(t);
+            r = Lerp(r, r1, vt);
+            g = Lerp(g, g1, vt);
+            b = Lerp(b, b1, vt);
+            a = Lerp(a, a1, vt);
+        }
+    }
+    else
+    {
+        // Closest level only
+        const MipLevel& level = mLevels[static_cast<uint32_t>(lod + 0.5f)];
+        if (filter == TextureFilter::Bilinear)
+        {
+            SampleBilinear(level, u, v, r, g, b, a);
+        }
+        else
+        {
+            SampleNearest(level, u, v, r, g, b, a);
+        }
+    }
+
+    const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+    r = _mm_mul_ps(r, scale);
+    g = _mm_mul_ps(g, scale);
+    b = _mm_mul_ps(b, scale);
+    a = _mm_mul_ps(a, scale);
+}
+
+void Texture::SampleNearest(const MipLevel& level, __m128 u, __m128 v, __m128& r, __m128& g, __m128& b, __m128& a) const
+{
+    const uint32_t* texels = mTexels.data() + level.offset;
+    const __m128 width = _mm_set1_ps(static_cast<float>(level.width));
+    const __m128 height = _mm_set1_ps(static_cast<float>(level.height));
+    const __m128 maxX = _mm_set1_ps(static_cast<float>(level.width - 1));
+    const __m128 maxY = _mm_set1_ps(static_cast<float>(level.height - 1));
+
+    const __m128 x = ClampTexel(Floor(_mm_mul_ps(Wrap(u), width)), maxX);
+    const __m128 y = ClampTexel(Floor(_mm_mul_ps(Wrap(v), height)), maxY);
+    Unpack(Fetch(texels, level.layout, x, y), r, g, b, a);
+}
+
+void Texture::SampleBilinear(const MipLevel& level, __m128 u, __m128 v, __m128& r, __m128& g, __m128& b, __m128& a) const
+{
+    const uint32_t* texels = mTexels.data() + level.offset;
+    const __m128 width = _mm_set1_ps(static_cast<float>(level.width));
+    const __m128 height = _mm_set1_ps(static_cast<float>(level.height));
+    const __m128 maxX = _mm_set1_ps(static_cast<float>(level.width - 1));
+    const __m128 maxY = _mm_set1_ps(static_cast<float>(level.height - 1));
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    // Texel centers are at +0.5, find the top left texel of the 2x2 footprint
+    const __m128 fx = _mm_sub_ps(_mm_mul_ps(Wrap(u), width), half);
+    const __m128 fy = _mm_sub_ps(_mm_mul_ps(Wrap(v), height), half);
+    __m128 x0 = Floor(fx);
+    __m128 y0 = Floor(fy);
+    const __m128 tx = _mm_sub_ps(fx, x0);
+    const __m128 ty = _mm_sub_ps(fy, y0);
+
+    // Wrap the footprint around the edges
+    x0 = _mm_add_ps(x0, _mm_and_ps(_mm_cmplt_ps(x0, zero), width));
+    y0 = _mm_add_ps(y0, _mm_and_ps(_mm_cmplt_ps(y0, zero), height));
+    __m128 x1 = _mm_add_ps(x0, one);
+    __m128 y1 = _mm_add_ps(y0, one);
+    x1 = _mm_sub_ps(x1, _mm_and_ps(_mm_cmpge_ps(x1, width), width));
+    y1 = _mm_sub_ps(y1, _mm_and_ps(_mm_cmpge_ps(y1, height), height));
+
+    x0 = ClampTexel(x0, maxX);
+    y0 = ClampTexel(y0, maxY);
+    x1 = ClampTexel(x1, maxX);
+    y1 = ClampTexel(y1, maxY);
+
+    __m128 r00, g00, b00, a00, r10, g10, b10, a10, r01, g01, b01, a01, r11, g11, b11, a11;
+    Unpack(Fetch(texels, level.layout, x0, y0), r00, g00, b00, a00);
+    Unpack(Fetch(texels, level.layout, x1, y0), r10, g10, b10, a10);
+    Unpack(Fetch(texels, level.layout, x0, y1), r01, g01, b01, a01);
+    Unpack(Fetch(texels, level.layout, x1, y1), r11, g11, b11, a11);
+
+    r = Lerp(Lerp(r00, r10, tx), Lerp(r01, r11, tx), ty);
+    g = Lerp(Lerp(g00, g10, tx), Lerp(g01, g11, tx), ty);
+    b = Lerp(Lerp(b00, b10, tx), Lerp(b01, b11, tx), ty);
+    a = Lerp(Lerp(a00, a10, tx), Lerp(a01, a11, tx), ty);
+}
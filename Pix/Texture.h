@@ -0,0 +1,61 @@
+#pragma once
+
+#include "SurfaceLayout.h"
+
+#include <cstdint>
+#include <emmintrin.h>
+#include <string>
+#include <vector>
+
+enum class TextureFilter
+{
+    Nearest,
+    Bilinear,
+    // Bilinear on the two closest mip levels, blended by the fractional lod
+    Trilinear,
+};
+
+// CPU side texture for the rasterizer.
+// Texels are packed RGBA8 (r in the low byte), rows top to bottom, so v = 0 is the top row.
+// The mip chain follows the base level in the same allocation, each level half the size of the previous.
+// Levels are built linear and can be swizzled to a tiled or Morton layout afterwards.
+class Texture
+{
+public:
+    // Load an uncompressed 24 or 32 bit BMP and build its mip chain
+    bool Load(const std::string& fileName);
+
+    uint32_t GetWidth() const { return mLevels.empty() ? 0 : mLevels[0].width; }
+    uint32_t GetHeight() const { return mLevels.empty() ? 0 : mLevels[0].height; }
+    uint32_t GetLevelCount() const { return static_cast<uint32_t>(mLevels.size()); }
+
+    // Reorder the texels of every level, sampling is unchanged
+    void SetLayout(MemoryLayout layout);
+    MemoryLayout GetLayout() const { return mLevels.empty() ? MemoryLayout::Linear : mLevels[0].layout.GetLayout(); }
+
+    // lod for a pixel footprint given the screen space derivatives of the texel coordinates
+    float GetLod(float dudx, float dvdx, float dudy, float dvdy) const;
+
+    // Sample 4 texels at once, one per SIMD lane, with wrap addressing.
+    // lod is log2 of the texels covered per pixel, 0 or less samples the base level.
+    // Returns colors in the 0-1 range.
+    void Sample(TextureFilter filter, float lod, __m128 u, __m128 v, __m128& r, __m128& g, __m128& b, __m128& a) const;
+
+private:
+    struct MipLevel
+    {
+        uint32_t offset;
+        uint32_t width;
+        uint32_t height;
+        SurfaceLayout layout;
+    };
+
+    // Box filter each level down from the previous one
+    void BuildMipChain();
+
+    void SampleNearest(const MipLevel& level, __m128 u, __m128 v, __m128& r, __m128& g, __m128& b, __m128& a) const;
+    void SampleBilinear(const MipLevel& level, __m128 u, __m128 v, __m128& r, __m128& g, __m128& b, __m128& a) const;
+
+    std::vector<uint32_t> mTexels;
+    std::vector<MipLevel> mLevels;
+};
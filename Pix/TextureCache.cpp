@@ -0,0 +1,43 @@
+#include "TextureCache.h"
+
+#include <XEngine.h>
+
+TextureCache* TextureCache::Get()
+{
+    static TextureCache sInstance;
+    return &sInstance;
+}
+
+const Texture* TextureCache::GetTexture(const std::string& fileName)
+{
+    auto iter = mTextures.find(fileName);
+    if (iter != mTextures.end())
+    {
+        return iter->second.get();
+    }
+
+    // Failed loads are not cached so a fixed file is picked up on the next run
+    auto texture = std::make_unique<Texture>();
+    const std::string root = X::ConfigGetString("PixTexturePath", "Images");
+    if (!texture->Load(root + "/" + fileName))
+    {
+        return nullptr;
+    }
+    texture->SetLayout(mLayout);
+
+    return mTextures.emplace(fileName, std::move(texture)).first->second.get();
+}
+
+void TextureCache::SetLayout(MemoryLayout layout)
+{
+    if (layout == mLayout)
+    {
+        return;
+    }
+
+    mLayout = layout;
+    for (auto& [fileName, texture] : mTextures)
+    {
+        texture->SetLayout(layout);
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+// Loads each texture file once and keeps it for the rasterizer
+class TextureCache
+{
+public:
+    static TextureCache* Get();
+
+public:
+    // Texture from the texture folder, loaded on first use. Returns nullptr if it can't be loaded.
+    const Texture* GetTexture(const std::string& fileName);
+
+    // Memory layout of all cached textures and the ones loaded later
+    void SetLayout(MemoryLayout layout);
+
+private:
+    std::map<std::string, std::unique_ptr<Texture>> mTextures;
+    MemoryLayout mLayout = MemoryLayout::Linear;
+};
@@ -0,0 +1,35 @@
+#include "TexturedShader.h"
+
+namespace
+{
+    constexpr float kAlphaCutoff = 0.5f;
+}
+
+void TexturedShader::ShadePixels(PixelBatch& batch) const
+{
+    const __m128 cutoff = _mm_set1_ps(kAlphaCutoff);
+    for (int i = 0; i < batch.count; i += 4)
+    {
+        __m128 r = _mm_load_ps(batch.varyings[PixelBatch::R] + i);
+        __m128 g = _mm_load_ps(batch.varyings[PixelBatch::G] + i);
+        __m128 b = _mm_load_ps(batch.varyings[PixelBatch::B] + i);
+        __m128 a = _mm_load_ps(batch.varyings[PixelBatch::A] + i);
+        if (batch.texture != nullptr)
+        {
+            const __m128 u = _mm_load_ps(batch.varyings[PixelBatch::U] + i);
+            const __m128 v = _mm_load_ps(batch.varyings[PixelBatch::V] + i);
+            __m128 texR, texG, texB, texA;
+            batch.texture->Sample(batch.filter, batch.GetLod(*batch.texture, i), u, v, texR, texG, texB, texA);
+            r = _mm_mul_ps(r, texR);
+            g = _mm_mul_ps(g, texG);
+            b = _mm_mul_ps(b, texB);
+            a = _mm_mul_ps(a, texA);
+        }
+
+        _mm_store_ps(batch.color[0] + i, r);
+        _mm_store_ps(batch.color[1] + i, g);
+        _mm_store_ps(batch.color[2] + i, b);
+        _mm_store_ps(batch.color[3] + i, a);
+        _mm_store_ps(batch.keep + i, _mm_cmpge_ps(a, cutoff));
+    }
+}
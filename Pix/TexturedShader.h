@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Shader.h"
+
+// Bound texture modulated by the vertex color, with an alpha test.
+// Pixels whose alpha ends up below the cutoff are discarded, so cutouts need no blending or sorting.
+class TexturedShader : public Shader
+{
+public:
+    const char* GetName() const override
+    {
+        return "textured";
+    }
+
+    void ShadePixels(PixelBatch& batch) const override;
+};
@@ -0,0 +1,85 @@
+#include "TransformState.h"
+
+#include <algorithm>
+
+using namespace X::Math;
+
+TransformState* TransformState::Get()
+{
+	static TransformState sInstance;
+	return &sInstance;
+}
+
+void TransformState::OnNewFrame()
+{
+	*this = {};
+}
+
+void TransformState::SetWorld(const Matrix4& world)
+{
+	mWorld = world;
+	UpdateTransform();
+}
+
+void TransformState::SetView(const Matrix4& view)
+{
+	mView = view;
+	UpdateTransform();
+}
+
+void TransformState::SetProjection(const Matrix4& projection)
+{
+	mProjection = projection;
+	mHasProjection = true;
+	UpdateTransform();
+}
+
+Matrix4 TransformState::MakeWorld(const Vector3& translation, const Vector3& rotation, const Vector3& scale)
+{
+	return
+		Matrix4::Scaling(scale) *
+		Matrix4::RotationX(rotation.x * kDegToRad) *
+		Matrix4::RotationY(rotation.y * kDegToRad) *
+		Matrix4::RotationZ(rotation.z * kDegToRad) *
+		Matrix4::Translation(translation);
+}
+
+Matrix4 TransformState::MakeLookAt(const Vector3& eye, const Vector3& target)
+{
+	// Same left handed, row vector convention as X::Camera
+	const Vector3 l = Normalize(target - eye);
+	const Vector3 up = Abs(l.y) < 0.999f ? Vector3::YAxis() : Vector3::ZAxis();
+	const Vector3 r = Normalize(Cross(up, l));
+	const Vector3 u = Normalize(Cross(l, r));
+	return Matrix4
+	(
+		r.x, u.x, l.x, 0.0f,
+		r.y, u.y, l.y, 0.0f,
+		r.z, u.z, l.z, 0.0f,
+		-Dot(r, eye), -Dot(u, eye), -Dot(l, eye), 1.0f
+	);
+}
+
+Matrix4 TransformState::MakePerspective(float fov, float aspectRatio, float nearPlane, float farPlane)
+{
+	const float h = 1.0f / tanf(fov * kDegToRad * 0.5f);
+	const float w = h / aspectRatio;
+	const float d = farPlane / (farPlane - nearPlane);
+	return Matrix4
+	(
+		w, 0.0f, 0.0f, 0.0f,
+		0.0f, h, 0.0f, 0.0f,
+		0.0f, 0.0f, d, 1.0f,
+		0.0f, 0.0f, -nearPlane * d, 0.0f
+	);
+}
+
+void TransformState::UpdateTransform()
+{
+	mTransform = mWorld * mView;
+	if (mHasProjection)
+		mTransform = mTransform * mProjection;
+
+	const Matrix4 identity = Matrix4::Identity();
+	mIsIdentity = !mHasProjection && std::equal(&mTransform._11, &mTransform._44 + 1, &identity._11);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <XMath.h>
+
+// World, view and projection matrices applied by the vertex stage.
+// Without a projection, vertices stay in pixel space and only world * view is applied.
+class TransformState
+{
+public:
+	static TransformState* Get();
+
+public:
+	void OnNewFrame();
+
+	void SetWorld(const X::Math::Matrix4& world);
+	void SetView(const X::Math::Matrix4& view);
+	void SetProjection(const X::Math::Matrix4& projection);
+
+	const X::Math::Matrix4& GetWorld() const { return mWorld; }
+	const X::Math::Matrix4& GetView() const { return mView; }
+	const X::Math::Matrix4& GetProjection() const { return mProjection; }
+
+	// Combined world * view * projection, projection is identity when not set
+	const X::Math::Matrix4& GetTransform() const { return mTransform; }
+
+	bool HasProjection() const { return mHasProjection; }
+	bool IsIdentity() const { return mIsIdentity; }
+
+	// Matrix builders, rotations are in degrees
+	static X::Math::Matrix4 MakeWorld(const X::Math::Vector3& translation, const X::Math::Vector3& rotation, const X::Math::Vector3& scale);
+	static X::Math::Matrix4 MakeLookAt(const X::Math::Vector3& eye, const X::Math::Vector3& target);
+	static X::Math::Matrix4 MakePerspective(float fov, float aspectRatio, float nearPlane, float farPlane);
+
+private:
+	void UpdateTransform();
+
+	X::Math::Matrix4 mWorld;
+	X::Math::Matrix4 mView;
+	X::Math::Matrix4 mProjection;
+	X::Math::Matrix4 mTransform;
+	bool mHasProjection = false;
+	bool mIsIdentity = true;
+};
@@ -0,0 +1,43 @@
+#include "TriangleSetup.h"
+
+bool TriangleSetup::Initialize(const Vertex& a, const Vertex& b, const Vertex& c)
+{
+    const float x1 = b.pos.x - a.pos.x, y1 = b.pos.y - a.pos.y;
+    const float x2 = c.pos.x - a.pos.x, y2 = c.pos.y - a.pos.y;
+    const float area = x1 * y2 - x2 * y1;
+    if (area == 0.0f)
+    {
+        return false;
+    }
+
+    auto values = [](const Vertex& v, float* out)
+    {
+        out[Z] = v.pos.z;
+        out[InvW] = v.invW;
+        out[R] = v.color.r * v.invW;
+        out[G] = v.color.g * v.invW;
+        out[B] = v.color.b * v.invW;
+        out[A] = v.color.a * v.invW;
+        out[U] = v.uv.x * v.invW;
+        out[V] = v.uv.y * v.invW;
+    };
+
+    float va[Count], vb[Count], vc[Count];
+    values(a, va);
+    values(b, vb);
+    values(c, vc);
+
+    // Solve the plane through the 3 vertices for each attribute
+    x0 = a.pos.x;
+    y0 = a.pos.y;
+    const float invArea = 1.0f / area;
+    for (int i = 0; i < Count; ++i)
+    {
+        const float d1 = vb[i] - va[i];
+        const float d2 = vc[i] - va[i];
+        origin[i] = va[i];
+        ddx[i] = (d1 * y2 - d2 * y1) * invArea;
+        ddy[i] = (d2 * x1 - d1 * x2) * invArea;
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <cstdint>
+
+// Per triangle plane equations for everything interpolated across it.
+// value(x, y) = origin + ddx * (x - x0) + ddy * (y - y0), all linear in screen space:
+// z as is, and 1/w plus every other attribute divided by w for perspective correction.
+struct TriangleSetup
+{
+    enum Attribute
+    {
+        Z,
+        InvW,
+        R,
+        G,
+        B,
+        A,
+        U,
+        V,
+        Count
+    };
+
+    // Returns false for triangles with no area
+    bool Initialize(const Vertex& a, const Vertex& b, const Vertex& c);
+
+    // Value of an attribute at the pixel (x, y)
+    float ValueAt(Attribute attribute, float x, float y) const
+    {
+        return origin[attribute] + ddx[attribute] * (x - x0) + ddy[attribute] * (y - y0);
+    }
+
+    float x0 = 0.0f;
+    float y0 = 0.0f;
+    float origin[Count] = {};
+    float ddx[Count] = {};
+    float ddy[Count] = {};
+};
+
+// A filled triangle ready to be drawn again without its vertices: the bounds and hash it tracks its tiles with,
+// its corners in 28.4 fixed point with positive winding, and its setup. Triangles with no area only track.
+struct PreparedTriangle
+{
+    TriangleSetup setup;
+    X::Color flatColor;
+    int64_t px[3] = {};
+    int64_t py[3] = {};
+    float minX = 0.0f;
+    float minY = 0.0f;
+    float maxX = 0.0f;
+    float maxY = 0.0f;
+    uint64_t hash = 0;
+    bool hasArea = false;
+};
@@ -12,6 +12,10 @@ VariableCache* VariableCache::Get()
 void VariableCache::Clear()
 {
 	mFloatVars.clear();
+	mEditorVars.clear();
+	mEdits.Reset();
+	mAdded.Reset();
+	mFloatVarsAdded = false;
 }
 
 bool VariableCache::IsVarName(const std::string& name) const
@@ -29,6 +33,7 @@ void VariableCache::AddFloat(const std::string& name, float value, float speed,
 	if (iter == mFloatVars.end())
 	{
 		mFloatVars.emplace_back(FloatVar{ name, value, speed, min, max });
+		mFloatVarsAdded = true;
 	}
 }
 
@@ -49,13 +54,57 @@ float VariableCache::GetFloat(const std::string& param)
 	return stof(param);
 }
 
+void VariableCache::SyncWithEditor()
+{
+	if (mEdits.Receive())
+	{
+		for (const auto& edit : mEdits.GetReadSlot())
+		{
+			auto iter = std::find_if(mFloatVars.begin(), mFloatVars.end(), [&edit](auto& var)
+			{
+				return var.name == edit.name;
+			});
+			if (iter != mFloatVars.end())
+				(*iter).value = edit.value;
+		}
+	}
+
+	if (mFloatVarsAdded)
+	{
+		mAdded.GetWriteSlot() = mFloatVars;
+		mAdded.Publish();
+		mFloatVarsAdded = false;
+	}
+}
+
 void VariableCache::ShowEditor()
 {
-	if (mFloatVars.empty())
+	// The editor owns the values of the variables it knows, the script only adds new ones
+	if (mAdded.Receive())
+	{
+		for (const auto& added : mAdded.GetReadSlot())
+		{
+			auto iter = std::find_if(mEditorVars.begin(), mEditorVars.end(), [&added](auto& var)
+			{
+				return var.name == added.name;
+			});
+			if (iter == mEditorVars.end())
+				mEditorVars.push_back(added);
+		}
+	}
+
+	if (mEditorVars.empty())
 		return;
 
+	bool edited = false;
 	ImGui::Begin("Variables", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
-	for (auto& var : mFloatVars)
-		ImGui::DragFloat(var.name.c_str(), &var.value, var.speed, var.min, var.max);
+	for (auto& var : mEditorVars)
+		edited |= ImGui::DragFloat(var.name.c_str(), &var.value, var.speed, var.min, var.max);
 	ImGui::End();
+
+	if (edited)
+	{
+		mEdits.GetWriteSlot() = mEditorVars;
+		mEdits.Publish();
+	}
 }
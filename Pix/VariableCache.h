@@ -1,21 +1,30 @@
 #pragma once
 
+#include "Mailbox.h"
+
 #include <string>
 #include <vector>
 
+// Variables are added and read by the script on the render thread and edited on the editor thread.
+// Each side keeps its own copy, the two swap snapshots through mailboxes once per frame.
 class VariableCache
 {
 public:
 	static VariableCache* Get();
 
 public:
+	// Only while the render thread is stopped
 	void Clear();
 
 	bool IsVarName(const std::string& name) const;
 
+	// Render thread
 	void AddFloat(const std::string& name, float value, float speed = 0.01f, float min = -FLT_MAX, float max = FLT_MAX);
 	float GetFloat(const std::string& param);
+	// Before each frame, take the values edited since the last one and hand newly added variables to the editor
+	void SyncWithEditor();
 
+	// Editor thread
 	void ShowEditor();
 
 private:
@@ -29,4 +38,8 @@ private:
 	};
 
 	std::vector<FloatVar> mFloatVars;
+	std::vector<FloatVar> mEditorVars;
+	Mailbox<std::vector<FloatVar>> mEdits;
+	Mailbox<std::vector<FloatVar>> mAdded;
+	bool mFloatVarsAdded = false;
 };
@@ -7,7 +7,6 @@ struct Vector2
     Vector2() : x(0.0f), y(0.0f) {}
     Vector2(float s) : x(s), y(s) {}
     Vector2(float x, float y) : x(x), y(y) {}
-    Vector2(const Vector2& v) : x(v.x), y(v.y) {}
 
     Vector2 operator-() const { return { -x, -y }; };
     Vector2 operator+(const Vector2& rhs) const { return { x + rhs.x, y + rhs.y }; };
@@ -6,6 +6,9 @@ struct Vertex
 {
     Vector3 pos;
     X::Color color;
+    Vector2 uv;
+    // 1 / clip w after projection, 1 when there is none
+    float invW = 1.0f;
 };
 
 inline Vector3 LerpPosition(const Vector3& a, const Vector3& b, float t)
@@ -29,11 +32,22 @@ inline X::Color LerpColor(const X::Color& a, const X::Color& b, float t)
     };
 }
 
+inline Vector2 LerpUV(const Vector2& a, const Vector2& b, float t)
+{
+    return
+    {
+        a.x + (b.x - a.x) * t,
+        a.y + (b.y - a.y) * t,
+    };
+}
+
 inline Vertex LerpVertex(const Vertex& a, const Vertex& b, float t)
 {
     Vertex v;
     v.pos = LerpPosition(a.pos, b.pos, t);
     v.color = LerpColor(a.color, b.color, t);
+    v.uv = LerpUV(a.uv, b.uv, t);
+    v.invW = a.invW + (b.invW - a.invW) * t;
 
     // set x/y into pixels instead of floats
     // helps prevent skipping pixels
@@ -0,0 +1,32 @@
+#include "VertexStream.h"
+
+void VertexStream::Add(const Vertex& vertex)
+{
+    const uint32_t i = mChannels.Append();
+    Data(Attribute::PosX)[i] = vertex.pos.x;
+    Data(Attribute::PosY)[i] = vertex.pos.y;
+    Data(Attribute::PosZ)[i] = vertex.pos.z;
+    Data(Attribute::PosW)[i] = 1.0f;
+    Data(Attribute::ColorR)[i] = vertex.color.r;
+    Data(Attribute::ColorG)[i] = vertex.color.g;
+    Data(Attribute::ColorB)[i] = vertex.color.b;
+    Data(Attribute::ColorA)[i] = vertex.color.a;
+    Data(Attribute::TexU)[i] = vertex.uv.x;
+    Data(Attribute::TexV)[i] = vertex.uv.y;
+}
+
+Vertex VertexStream::Get(uint32_t index) const
+{
+    Vertex v;
+    v.pos.x = Data(Attribute::PosX)[index];
+    v.pos.y = Data(Attribute::PosY)[index];
+    v.pos.z = Data(Attribute::PosZ)[index];
+    v.invW = Data(Attribute::PosW)[index];
+    v.color.r = Data(Attribute::ColorR)[index];
+    v.color.g = Data(Attribute::ColorG)[index];
+    v.color.b = Data(Attribute::ColorB)[index];
+    v.color.a = Data(Attribute::ColorA)[index];
+    v.uv.x = Data(Attribute::TexU)[index];
+    v.uv.y = Data(Attribute::TexV)[index];
+    return v;
+}
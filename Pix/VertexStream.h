@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ChannelStorage.h"
+#include "Vertex.h"
+
+#include <cstdint>
+
+// Structure of arrays vertex storage, one aligned float array per attribute.
+// Arrays are padded to whole SIMD lanes so batch loops need no scalar tail.
+// PosW is 1 for input vertices and 1/w once processed, which Get returns as Vertex::invW.
+class VertexStream
+{
+public:
+    enum class Attribute
+    {
+        PosX,
+        PosY,
+        PosZ,
+        PosW,
+        ColorR,
+        ColorG,
+        ColorB,
+        ColorA,
+        TexU,
+        TexV,
+        Count
+    };
+
+    static constexpr uint32_t kLaneWidth = ChannelStorage<static_cast<uint32_t>(Attribute::Count)>::kLaneWidth;
+
+public:
+    void Clear() { mChannels.Clear(); }
+    // Resize the stream, growing the storage while keeping existing vertices
+    void Resize(uint32_t size) { mChannels.Resize(size); }
+
+    void Add(const Vertex& vertex);
+    Vertex Get(uint32_t index) const;
+
+    uint32_t Size() const { return mChannels.Size(); }
+    // Size rounded up to a whole number of SIMD lanes
+    uint32_t PaddedSize() const { return mChannels.PaddedSize(); }
+
+    float* Data(Attribute attribute) { return mChannels.Data(static_cast<uint32_t>(attribute)); }
+    const float* Data(Attribute attribute) const { return mChannels.Data(static_cast<uint32_t>(attribute)); }
+
+private:
+    ChannelStorage<static_cast<uint32_t>(Attribute::Count)> mChannels;
+};
@@ -0,0 +1,84 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+uint32_t WorkerPool::GetMaxThreads()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void WorkerPool::Run(const std::function<void()>& task, uint32_t threadCount)
+{
+    const uint32_t helperCount = std::min(threadCount, GetMaxThreads()) - std::min(threadCount, 1u);
+    if (helperCount == 0)
+    {
+        task();
+        return;
+    }
+
+    // Started on first use, a pool that only ever runs on one thread costs nothing
+    if (mThreads.empty())
+    {
+        for (uint32_t i = 0; i + 1 < GetMaxThreads(); ++i)
+        {
+            mThreads.emplace_back(&WorkerPool::WorkerLoop, this, i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = &task;
+        mHelperCount = helperCount;
+        mPending = helperCount;
+        ++mJob;
+    }
+    mWake.notify_all();
+
+    task();
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this]() { return mPending == 0; });
+    mTask = nullptr;
+}
+
+void WorkerPool::WorkerLoop(uint32_t index)
+{
+    // A helper a job needs cannot miss it, the job only finishes once that helper ran it
+    uint64_t lastJob = 0;
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mWake.wait(lock, [&]() { return mStopping || mJob != lastJob; });
+        if (mStopping)
+        {
+            return;
+        }
+        lastJob = mJob;
+        if (index >= mHelperCount)
+        {
+            continue;
+        }
+
+        const std::function<void()>* task = mTask;
+        lock.unlock();
+        (*task)();
+        lock.lock();
+        if (--mPending == 0)
+        {
+            mDone.notify_one();
+        }
+    }
+}
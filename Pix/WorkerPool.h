@@ -0,0 +1,40 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads kept for the life of the pool and woken for each job, so work split many times a frame
+// does not pay for creating and joining threads every time.
+class WorkerPool
+{
+public:
+    WorkerPool() = default;
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Threads Run can use at most, the calling thread included
+    static uint32_t GetMaxThreads();
+
+    // Call task on the calling thread and on threadCount - 1 pool threads at once, and return once every call returned.
+    // The task splits the work between the calls itself, e.g. by pulling items from a shared counter.
+    void Run(const std::function<void()>& task, uint32_t threadCount);
+
+private:
+    void WorkerLoop(uint32_t index);
+
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    const std::function<void()>* mTask = nullptr;
+    uint64_t mJob = 0;
+    uint32_t mHelperCount = 0;
+    uint32_t mPending = 0;
+    bool mStopping = false;
+};
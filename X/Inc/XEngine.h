@@ -66,6 +66,11 @@ namespace X
 	void DrawSphere(const Math::Vector3& center, float radius, const Color& color, uint32_t slices = 8, uint32_t rings = 4);
 	void DrawSphere(float x, float y, float z, float radius, const Color& color, uint32_t slices = 8, uint32_t rings = 4);
 	void DrawPixel(int x, int y, const Color& color);
+	// Packed RGBA8 image (r in the low byte) drawn once this frame at the render texture origin, magnified by the pixel
+	// size with nearest sampling and under any screen grid, pixels with zero alpha leave the background
+	void DrawPixels(const uint32_t* pixels, uint32_t width, uint32_t height);
+	// Same, but only the changed areas are uploaded, the rest is what the last call of the same size left
+	void DrawPixels(const uint32_t* pixels, uint32_t width, uint32_t height, const PixelRect* changed, uint32_t changedCount);
 	void DrawScreenLine(const Math::Vector2& v0, const Math::Vector2& v1, const Color& color);
 	void DrawScreenLine(float x0, float y0, float x1, float y1, const Color& color);
 	void DrawScreenRect(const Math::Rect& rect, const Color& color);
@@ -34,6 +34,15 @@ namespace X
 		Both
 	};
 
+	// Area of a pixel image, right and bottom are exclusive
+	struct PixelRect
+	{
+		uint32_t left;
+		uint32_t top;
+		uint32_t right;
+		uint32_t bottom;
+	};
+
 	namespace Keys
 	{
 		// Keyboard roll 1
@@ -178,4 +178,25 @@ void SpriteRenderer::Draw(const Texture& texture, const Math::Rect& sourceRect,
 	DirectX::XMFLOAT2 origin = GetOrigin(rect.right - rect.left, rect.bottom - rect.top, pivot);
 	DirectX::SpriteEffects effects = GetSpriteEffects(flip);
 	mSpriteBatch->Draw(texture.mShaderResourceView, ToXMFLOAT2(pos), &rect, DirectX::Colors::White, rotation, origin, 1.0f, effects);
+}
+
+//----------------------------------------------------------------------------------------------------
+void SpriteRenderer::DrawMagnified(const Texture& texture, uint32_t scale)
+{
+	XASSERT(mSpriteBatch != nullptr, "[SpriteRenderer] Not initialized.");
+	mSpriteBatch->Begin(
+		DirectX::SpriteSortMode_Immediate,
+		mCommonStates->NonPremultiplied(),
+		mCommonStates->PointClamp(),
+		nullptr,
+		nullptr,
+		nullptr,
+		DirectX::XMMATRIX(
+			mTransform._11, mTransform._12, mTransform._13, mTransform._14,
+			mTransform._21, mTransform._22, mTransform._23, mTransform._24,
+			mTransform._31, mTransform._32, mTransform._33, mTransform._34,
+			mTransform._41, mTransform._42, mTransform._43, mTransform._44
+		));
+	mSpriteBatch->Draw(texture.mShaderResourceView, DirectX::XMFLOAT2(0.0f, 0.0f), nullptr, DirectX::Colors::White, 0.0f, DirectX::XMFLOAT2(0.0f, 0.0f), static_cast<float>(scale), DirectX::SpriteEffects_None);
+	EndRender();
 }
\ No newline at end of file
@@ -40,6 +40,9 @@ public:
 	void Draw(const Texture& texture, const Math::Vector2& pos, float rotation = 0.0f, Pivot pivot = Pivot::Center, Flip flip = Flip::None);
 	void Draw(const Texture& texture, const Math::Rect& sourceRect, const Math::Vector2& pos, float rotation = 0.0f, Pivot pivot = Pivot::Center, Flip flip = Flip::None);
 
+	// Draws the texture at the origin scaled by a whole factor with point sampling, in its own batch
+	void DrawMagnified(const Texture& texture, uint32_t scale);
+
 private:
 	friend class Font;
 
@@ -111,6 +111,70 @@ bool Texture::Initialize(const void* data, uint32_t width, uint32_t height)
 
 //----------------------------------------------------------------------------------------------------
 
+bool Texture::Initialize(uint32_t width, uint32_t height)
+{
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = width;
+	desc.Height = height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	ID3D11Device* device = GraphicsSystem::Get()->GetDevice();
+
+	ID3D11Texture2D* texture = nullptr;
+	HRESULT hr = device->CreateTexture2D(&desc, nullptr, &texture);
+	if (FAILED(hr))
+	{
+		XLOG("[Texture] Failed to create updatable texture. HRESULT: 0x%x)", hr);
+		return false;
+	}
+
+	hr = device->CreateShaderResourceView(texture, nullptr, &mShaderResourceView);
+	SafeRelease(texture);
+	if (FAILED(hr))
+	{
+		XLOG("[Texture] Failed to create shader resource view. HRESULT: 0x%x)", hr);
+		return false;
+	}
+
+	mWidth = width;
+	mHeight = height;
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+
+void Texture::Update(const void* data)
+{
+	Update(data, 0, 0, mWidth, mHeight);
+}
+
+//----------------------------------------------------------------------------------------------------
+
+void Texture::Update(const void* data, uint32_t left, uint32_t top, uint32_t right, uint32_t bottom)
+{
+	XASSERT(mShaderResourceView != nullptr, "[Texture] Texture not initialized.");
+	XASSERT(left < right && right <= mWidth && top < bottom && bottom <= mHeight, "[Texture] Invalid update area.");
+
+	ID3D11Resource* resource = nullptr;
+	mShaderResourceView->GetResource(&resource);
+
+	// Only the box is copied, so the rest keeps what earlier updates wrote
+	const D3D11_BOX box = { left, top, 0, right, bottom, 1 };
+	const uint8_t* src = static_cast<const uint8_t*>(data) + (top * mWidth + left) * 4;
+	GraphicsSystem::Get()->GetContext()->UpdateSubresource(resource, 0, &box, src, mWidth * 4, 0);
+	SafeRelease(resource);
+}
+
+//----------------------------------------------------------------------------------------------------
+
 void Texture::Terminate()
 {
 	SafeRelease(mShaderResourceView);
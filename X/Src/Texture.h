@@ -16,7 +16,13 @@ public:
 	
 	bool Initialize(const char* fileName);
 	bool Initialize(const void* data, uint32_t width, uint32_t height);
+	bool Initialize(uint32_t width, uint32_t height);
 	void Terminate();
+
+	// Replace the contents of a texture created without data, rows are width * 4 bytes apart
+	void Update(const void* data);
+	// Same, but only the area from left, top up to right, bottom (exclusive), data still holds the whole image
+	void Update(const void* data, uint32_t left, uint32_t top, uint32_t right, uint32_t bottom);
 	
 	void BindVS(uint32_t index);
 	void BindPS(uint32_t index);
@@ -91,6 +91,10 @@ namespace
 
 	RenderTarget myRenderTarget;
 	bool useRenderTarget = false;
+	uint32_t myPixelSize = 1;
+
+	Texture myPixelTexture;
+	bool drawPixelTexture = false;
 
 	std::vector<SpriteCommand> mySpriteCommands;
 	std::vector<TextCommand> myTextCommands;
@@ -285,6 +289,13 @@ void X::Run(GameLoop gameLoop)
 		mySpriteCommands.clear();
 		SpriteRenderer::Get()->EndRender();
 
+		// Pixels are magnified here, below the grid and screen lines
+		if (drawPixelTexture)
+		{
+			SpriteRenderer::Get()->DrawMagnified(myPixelTexture, myPixelSize);
+			drawPixelTexture = false;
+		}
+
 		// Render
 		SimpleDraw::Render(myCamera);
 
@@ -318,6 +329,7 @@ void X::Stop()
 
 	// Terminate render target
 	myRenderTarget.Terminate();
+	myPixelTexture.Terminate();
 
 	// Shutdown all engine systems
 	Gui::Terminate();
@@ -513,6 +525,44 @@ void X::DrawPixel(int x, int y, const Color& color)
 	SimpleDraw::AddPixel(x, y, color);
 }
 
+void X::DrawPixels(const uint32_t* pixels, uint32_t width, uint32_t height)
+{
+	XASSERT(initialized, "[XEngine] Engine not started.");
+	if (width == 0 || height == 0)
+		return;
+
+	// Keep the texture between frames, it only changes with the resolution
+	if (myPixelTexture.GetWidth() != width || myPixelTexture.GetHeight() != height)
+	{
+		myPixelTexture.Terminate();
+		if (!myPixelTexture.Initialize(width, height))
+			return;
+	}
+	myPixelTexture.Update(pixels);
+	drawPixelTexture = true;
+}
+
+void X::DrawPixels(const uint32_t* pixels, uint32_t width, uint32_t height, const PixelRect* changed, uint32_t changedCount)
+{
+	XASSERT(initialized, "[XEngine] Engine not started.");
+	if (width == 0 || height == 0)
+		return;
+
+	// A new texture has nothing to keep, so it takes the whole image
+	if (myPixelTexture.GetShaderResourceView() == nullptr || myPixelTexture.GetWidth() != width || myPixelTexture.GetHeight() != height)
+	{
+		DrawPixels(pixels, width, height);
+		return;
+	}
+	for (uint32_t i = 0; i < changedCount; ++i)
+	{
+		const PixelRect& rect = changed[i];
+		if (rect.left < rect.right && rect.right <= width && rect.top < rect.bottom && rect.bottom <= height)
+			myPixelTexture.Update(pixels, rect.left, rect.top, rect.right, rect.bottom);
+	}
+	drawPixelTexture = true;
+}
+
 void X::DrawScreenLine(const Math::Vector2& v0, const Math::Vector2& v1, const Color& color)
 {
 	XASSERT(initialized, "[XEngine] Engine not started.");
@@ -657,15 +707,22 @@ uint32_t X::GetScreenHeight()
 
 void X::InitRenderTexture(uint32_t width, uint32_t height, uint32_t pixelSize)
 {
+	// Render target is no larger than the back buffer
+	const uint32_t bufferWidth = X::Math::Min(width * pixelSize, GetScreenWidth());
+	const uint32_t bufferHeight = X::Math::Min(height * pixelSize, GetScreenHeight());
+
+	// Scripts set their resolution every frame, only rebuild the render target when it changes
+	if (useRenderTarget && bufferWidth == myRenderTarget.GetWidth() && bufferHeight == myRenderTarget.GetHeight() && pixelSize == myPixelSize)
+		return;
+
 	// Clear any old render target data
 	if (useRenderTarget)
 		myRenderTarget.Terminate();
 
 	useRenderTarget = true;
+	myPixelSize = pixelSize;
 
-	// Initialize render target (no larger than the back buffer)
-	const uint32_t bufferWidth = X::Math::Min(width * pixelSize, GetScreenWidth());
-	const uint32_t bufferHeight = X::Math::Min(height * pixelSize, GetScreenHeight());
+	// Initialize render target
 	myRenderTarget.Initialize(bufferWidth, bufferHeight, X::RenderTarget::Format::RGBA_U8);
 
 	// Set camera aspect ratio